@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace Util
+{
+
+// xoshiro256** pseudo random generator, seeded through splitmix64 as recommended by its authors.
+// Satisfies UniformRandomBitGenerator, so it also works with the distributions of <random>.
+struct [[nodiscard]] Random final
+{
+    using result_type = std::uint64_t;
+
+    // NOTE: unseeded generators draw their seed from the entropy device, once
+    Random()
+      : Random { entropy() }
+    {}
+
+    explicit Random(const std::uint64_t value) { seed(value); }
+
+    void seed(std::uint64_t value)
+    {
+        for (auto& word : state) { word = splitmix64(value); }
+    }
+
+    [[nodiscard]] constexpr static auto min() -> result_type { return 0; }
+    [[nodiscard]] constexpr static auto max() -> result_type { return std::numeric_limits<result_type>::max(); }
+
+    auto operator()() -> result_type
+    {
+        const auto result = std::rotl(state[1] * 5, 7) * 9;
+        const auto t      = state[1] << 17U;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = std::rotl(state[3], 45);
+
+        return result;
+    }
+
+    // Uniformly distributed in [min, max], without the modulo bias
+    [[nodiscard]] auto natural(const std::size_t min, const std::size_t max) -> std::size_t
+    {
+        if (max == 0) { return 0; }
+
+        const auto range = static_cast<std::uint64_t>(max - min) + 1;
+        if (range == 0) { return (*this)(); }
+
+        // NOTE: Lemire's nearly divisionless method, the division only runs on the rare rejections
+        auto product = static_cast<unsigned __int128>((*this)()) * range;
+        if (static_cast<std::uint64_t>(product) < range) {
+            const auto threshold = -range % range;
+            while (static_cast<std::uint64_t>(product) < threshold) {
+                product = static_cast<unsigned __int128>((*this)()) * range;
+            }
+        }
+
+        return min + static_cast<std::size_t>(product >> 64U);
+    }
+
+    // Uniformly distributed in [0, 1)
+    [[nodiscard]] auto unit_float() -> float
+    {
+        constexpr auto MANTISSA_BITS = std::numeric_limits<float>::digits;
+        return static_cast<float>((*this)() >> (64U - MANTISSA_BITS)) * (1.0F / (1U << MANTISSA_BITS));
+    }
+
+    // Advances the generator by 2^128 draws
+    void jump()
+    {
+        constexpr std::array<std::uint64_t, 4> JUMP = {
+            0x180e'c6d3'3cfd'0abaULL,
+            0xd5a6'1266'f0c9'392cULL,
+            0xa958'2618'e03f'c9aaULL,
+            0x39ab'dc45'29b1'661cULL,
+        };
+
+        std::array<std::uint64_t, 4> jumped = {};
+        for (const auto word : JUMP) {
+            for (std::uint32_t bit = 0; bit < 64; ++bit) {
+                if ((word & (1ULL << bit)) != 0) {
+                    for (std::size_t idx = 0; idx < state.size(); ++idx) { jumped[idx] ^= state[idx]; }
+                }
+                (void)(*this)();
+            }
+        }
+
+        state = jumped;
+    }
+
+    // Substream made of the next 2^128 draws of this generator, which then continues right after them.
+    // Substreams split off one after the other never overlap, so each can be consumed by a different
+    // thread and the outcome still only depends on the seed.
+    [[nodiscard]] auto split() -> Random
+    {
+        auto substream = *this;
+        jump();
+        return substream;
+    }
+
+    [[nodiscard]] auto operator==(const Random&) const -> bool = default;
+
+    void serialize(this auto& self, auto& archive) { archive(self.state); }
+
+  private:
+    [[nodiscard]] static auto entropy() -> std::uint64_t
+    {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32U) | device();
+    }
+
+    [[nodiscard]] constexpr static auto splitmix64(std::uint64_t& value) -> std::uint64_t
+    {
+        auto z = (value += 0x9e37'79b9'7f4a'7c15ULL);
+        z      = (z ^ (z >> 30U)) * 0xbf58'476d'1ce4'e5b9ULL;
+        z      = (z ^ (z >> 27U)) * 0x94d0'49bb'1331'11ebULL;
+        return z ^ (z >> 31U);
+    }
+
+    std::array<std::uint64_t, 4> state = {};
+};
+
+} // namespace Util
@@ -1,7 +1,6 @@
 #include "Util.hpp"
 
 #include <fstream>
-#include <random>
 #include <sstream>
 
 namespace Util
@@ -31,22 +30,4 @@ void write_to_file(const std::filesystem::path& file_path, const std::string& co
     file << content;
 }
 
-auto random_float() -> float
-{
-    std::random_device                    rd;
-    std::mt19937                          gen(rd());
-    std::uniform_real_distribution<float> dis(0.0F, 1.0F);
-    return dis(gen);
-}
-
-auto random_natural(const std::size_t min, const std::size_t max) -> std::size_t
-{
-    if (max == 0) { return 0; }
-
-    std::random_device                         rd;
-    std::mt19937                               gen(rd());
-    std::uniform_int_distribution<std::size_t> dis(min, max);
-    return dis(gen);
-}
-
 } // namespace Util
@@ -75,9 +75,6 @@ template<typename Alternative>
 [[nodiscard]] auto read_entire_file(const std::filesystem::path& file_path) -> std::optional<std::string>;
 void               write_to_file(const std::filesystem::path& file_path, const std::string& content);
 
-[[nodiscard]] auto random_float() -> float;
-[[nodiscard]] auto random_natural(const std::size_t min, const std::size_t max) -> std::size_t;
-
 
 [[nodiscard]] constexpr static auto parse_double(const std::string& str) -> std::optional<double>
 {
@@ -0,0 +1,333 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <format>
+#include <limits>
+#include <new>
+#include <optional>
+#include <print>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Random.hpp"
+#include "Util.hpp"
+#include "simulations/Scheduler.hpp"
+
+namespace
+{
+
+std::atomic<std::size_t> allocations = 0;
+
+[[nodiscard]] auto counted_alloc(const std::size_t size) noexcept -> void*
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(std::max(size, std::size_t { 1 }));
+}
+
+// NOTE: for the over-aligned types, such as the cores of a simulation, whose size is rounded up to a multiple of the
+// alignment as std::aligned_alloc requires
+[[nodiscard]] auto counted_alloc(const std::size_t size, const std::align_val_t alignment) noexcept -> void*
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    return std::aligned_alloc(align, (std::max(size, std::size_t { 1 }) + align - 1) / align * align);
+}
+
+[[nodiscard]] auto throwing(void* memory) -> void*
+{
+    if (memory == nullptr) { throw std::bad_alloc {}; }
+
+    return memory;
+}
+
+} // namespace
+
+// NOTE: every allocation function is replaced so that the bench can tell how many heap allocations a simulated tick
+// costs, whatever the form of `new` that made them
+auto operator new(const std::size_t size) -> void* { return throwing(counted_alloc(size)); }
+auto operator new[](const std::size_t size) -> void* { return throwing(counted_alloc(size)); }
+auto operator new(const std::size_t size, const std::nothrow_t& /* tag */) noexcept -> void*
+{
+    return counted_alloc(size);
+}
+auto operator new[](const std::size_t size, const std::nothrow_t& /* tag */) noexcept -> void*
+{
+    return counted_alloc(size);
+}
+auto operator new(const std::size_t size, const std::align_val_t alignment) -> void*
+{
+    return throwing(counted_alloc(size, alignment));
+}
+auto operator new[](const std::size_t size, const std::align_val_t alignment) -> void*
+{
+    return throwing(counted_alloc(size, alignment));
+}
+auto operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t& /* tag */) noexcept
+  -> void*
+{
+    return counted_alloc(size, alignment);
+}
+auto operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t& /* tag */) noexcept
+  -> void*
+{
+    return counted_alloc(size, alignment);
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t /* size */) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t /* size */) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t& /* tag */) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t& /* tag */) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t /* alignment */) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t /* alignment */) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t /* size */, std::align_val_t /* alignment */) noexcept
+{
+    std::free(memory);
+}
+void operator delete[](void* memory, std::size_t /* size */, std::align_val_t /* alignment */) noexcept
+{
+    std::free(memory);
+}
+void operator delete(void* memory, std::align_val_t /* alignment */, const std::nothrow_t& /* tag */) noexcept
+{
+    std::free(memory);
+}
+void operator delete[](void* memory, std::align_val_t /* alignment */, const std::nothrow_t& /* tag */) noexcept
+{
+    std::free(memory);
+}
+
+namespace
+{
+
+constexpr std::size_t   DEFAULT_CORES     = 64;
+constexpr std::size_t   DEFAULT_PROCESSES = 20'000;
+constexpr std::size_t   REPETITIONS       = 5;
+constexpr std::uint32_t WORKLOAD_SEED     = 42;
+
+// NOTE: seeded so that every scheduler under measurement runs the very same workload
+template<typename Simulation>
+void spawn_workload(Simulation& sim, const std::size_t processes)
+{
+    Util::Random                               rng { WORKLOAD_SEED };
+    std::uniform_int_distribution<std::size_t> arrival { 0, processes };
+    std::uniform_int_distribution<std::size_t> events_count { 1, 8 };
+    std::uniform_int_distribution<std::size_t> duration { 1, 20 };
+    std::uniform_real_distribution<float>      usage { 0.01F, 1.0F };
+
+    std::vector<Os::Event> events;
+    for (std::size_t pid = 0; pid < processes; ++pid) {
+        events.clear();
+        const auto count = events_count(rng);
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            events.push_back(Os::Event {
+              .kind           = idx % 2 == 0 ? Os::EventKind::Cpu : Os::EventKind::Io,
+              .duration       = duration(rng),
+              .resource_usage = usage(rng),
+            });
+        }
+
+        (void)sim.emplace_process("bench", pid, arrival(rng), events);
+    }
+}
+
+// Round Robin as it was before preempting through the time slice of the core: every process kept its events in a
+// deque of its own, and a dispatch carved the quantum off the front CPU burst and pushed it in front of them, to be
+// popped once run. Only that bookkeeping is replayed here, next to the time slice, so that its allocations can be
+// told apart from the rest of the tick.
+struct [[nodiscard]] CarvingRoundRobinPolicy final
+{
+    struct [[nodiscard]] CarvedEvents final
+    {
+        std::deque<Os::Event> events;
+        bool                  carved = false;
+    };
+
+    std::vector<CarvedEvents> processes;
+
+    [[nodiscard]] constexpr static auto ready_order() -> Simulations::ReadyOrder
+    {
+        return Simulations::ReadyOrder::Fifo;
+    }
+
+    // NOTE: copies the events of the workload, before the allocations of the stepping are counted
+    template<typename Simulation>
+    void prepare(const Simulation& sim)
+    {
+        processes.assign(sim.arena.size(), {});
+        for (std::size_t handle = 0; handle < processes.size(); ++handle) {
+            const auto& process = sim.process(static_cast<Simulations::ProcessArena::Handle>(handle));
+            for (auto idx = process.events.offset; idx < process.events.end(); ++idx) {
+                processes[handle].events.push_back(sim.event_pool.event(idx));
+            }
+        }
+    }
+
+    template<typename Simulation>
+    void operator()(Simulation& sim, const std::size_t thread_idx)
+    {
+        auto& ready = sim.ready_queue(thread_idx);
+        if (sim.cores[thread_idx].running || ready.empty()) { return; }
+
+        const auto handle = ready.pop();
+        auto&      carved = processes[handle];
+
+        // NOTE: the quantum carved at the previous dispatch has been run by now
+        if (std::exchange(carved.carved, false)) { carved.events.pop_front(); }
+
+        if (sim.arena.remainings[handle] > sim.quantum) {
+            auto event     = carved.events.front();
+            event.duration = sim.quantum;
+            carved.events.push_front(event);
+            carved.carved = true;
+        }
+
+        sim.run(thread_idx, handle, sim.quantum);
+    }
+};
+
+struct [[nodiscard]] Measurement final
+{
+    double nanoseconds_per_tick = std::numeric_limits<double>::max();
+    double allocations_per_tick = 0;
+};
+
+// Best wall-clock time per simulated tick over a few runs, stepping one tick at a time, tracing into `trace_path`
+// when given. Allocations are counted while stepping, the ones spawning the workload are left out.
+template<typename Policy>
+[[nodiscard]] auto measure(
+  const Policy&                               policy,
+  const std::size_t                           cores,
+  const std::size_t                           processes,
+  const std::optional<std::filesystem::path>& trace_path = std::nullopt
+) -> Measurement
+{
+    Measurement best;
+    for (std::size_t repetition = 0; repetition < REPETITIONS; ++repetition) {
+        Simulations::BasicScheduler<Policy> sim { policy };
+        sim.set_threads_count(cores);
+        spawn_workload(sim, processes);
+        if constexpr (requires { sim.schedule_policy.prepare(sim); }) { sim.schedule_policy.prepare(sim); }
+        if (trace_path) { sim.trace = Simulations::TraceFile::create(*trace_path); }
+
+        const auto allocations_before = allocations.load(std::memory_order_relaxed);
+        const auto start              = std::chrono::steady_clock::now();
+        while (!sim.complete()) { sim.step(); }
+        const auto elapsed   = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+        const auto allocated = allocations.load(std::memory_order_relaxed) - allocations_before;
+
+        const auto ticks          = static_cast<double>(sim.timer);
+        best.nanoseconds_per_tick = std::min(best.nanoseconds_per_tick, elapsed.count() / ticks);
+        best.allocations_per_tick = static_cast<double>(allocated) / ticks;
+    }
+
+    return best;
+}
+
+template<typename Policy>
+void compare_dispatch(const Simulations::SchedulePolicy kind, const std::size_t cores, const std::size_t processes)
+{
+    const auto baked  = measure(Policy {}, cores, processes);
+    const auto erased = measure(Simulations::named_scheduler_from_policy(kind), cores, processes);
+    std::println(
+      "{:<32} {:>16.1f} {:>16.1f} {:>9.2f}x {:>14.3f}",
+      std::format("{}", kind),
+      baked.nanoseconds_per_tick,
+      erased.nanoseconds_per_tick,
+      erased.nanoseconds_per_tick / baked.nanoseconds_per_tick,
+      baked.allocations_per_tick
+    );
+}
+
+// Round Robin preempting through the time slice of the core against carving the quantum off the events
+void compare_preemption(const std::size_t cores, const std::size_t processes)
+{
+    const auto carving = measure(CarvingRoundRobinPolicy {}, cores, processes);
+    const auto slicing = measure(Simulations::RoundRobinPolicy {}, cores, processes);
+
+    const auto print_row = [](const std::string_view name, const Measurement& measured) {
+        std::println("{:<32} {:>16.1f} {:>14.3f}", name, measured.nanoseconds_per_tick, measured.allocations_per_tick);
+    };
+
+    print_row("carving quanta (before)", carving);
+    print_row("time slice (after)", slicing);
+}
+
+// NOTE: the trace goes to a temporary file, removed once measured
+template<typename Policy>
+void compare_tracing(const Simulations::SchedulePolicy kind, const std::size_t cores, const std::size_t processes)
+{
+    const auto trace_path = std::filesystem::temp_directory_path() / "scheduler-bench.trace";
+    const auto untraced   = measure(Policy {}, cores, processes);
+    const auto traced     = measure(Policy {}, cores, processes, trace_path);
+
+    std::error_code error;
+    std::filesystem::remove(trace_path, error);
+
+    std::println(
+      "{:<32} {:>16.1f} {:>16.1f} {:>9.2f}x {:>14.3f}",
+      std::format("{}", kind),
+      untraced.nanoseconds_per_tick,
+      traced.nanoseconds_per_tick,
+      traced.nanoseconds_per_tick / untraced.nanoseconds_per_tick,
+      traced.allocations_per_tick
+    );
+}
+
+} // namespace
+
+auto main(int argc, const char** argv) -> int
+{
+    if (argc > 3) {
+        std::println(stderr, "[ERROR] too many arguments");
+        std::println("usage: scheduler-bench [cores] [processes]");
+        return 1;
+    }
+
+    const auto cores     = argc > 1 ? Util::parse_number(argv[1]) : std::optional { DEFAULT_CORES };
+    const auto processes = argc > 2 ? Util::parse_number(argv[2]) : std::optional { DEFAULT_PROCESSES };
+    if (!cores || !processes) { return 1; }
+    if (*cores == 0) {
+        std::println(stderr, "[ERROR] a simulation needs at least one core");
+        return 1;
+    }
+
+    std::println("{} cores, {} processes, best of {} runs", *cores, *processes, REPETITIONS);
+    std::println(
+      "{:<32} {:>16} {:>16} {:>10} {:>14}", "policy", "static ns/tick", "runtime ns/tick", "slowdown", "allocs/tick"
+    );
+
+    using namespace Simulations;
+    compare_dispatch<FirstComeFirstServedPolicy>(SchedulePolicy::FirstComeFirstServed, *cores, *processes);
+    compare_dispatch<RoundRobinPolicy>(SchedulePolicy::RoundRobin, *cores, *processes);
+    compare_dispatch<ShortestJobFirstPolicy>(SchedulePolicy::ShortestJobFirst, *cores, *processes);
+    compare_dispatch<ShortestRemainingTimeFirstPolicy>(
+      SchedulePolicy::ShortestRemainingTimeFirst, *cores, *processes
+    );
+    compare_dispatch<MultiLevelFeedbackQueuePolicy>(SchedulePolicy::MultiLevelFeedbackQueue, *cores, *processes);
+    compare_dispatch<CompletelyFairPolicy>(SchedulePolicy::CompletelyFair, *cores, *processes);
+
+    std::println();
+    std::println("{:<32} {:>16} {:>14}", "round robin preemption", "ns/tick", "allocs/tick");
+    compare_preemption(*cores, *processes);
+
+    std::println();
+    if (*cores > TRACE_MAX_CORES) {
+        std::println("tracing not measured, more than {} cores cannot be traced", TRACE_MAX_CORES);
+        return 0;
+    }
+
+    std::println(
+      "{:<32} {:>16} {:>16} {:>10} {:>14}", "policy", "untraced ns/tick", "traced ns/tick", "overhead", "allocs/tick"
+    );
+    compare_tracing<RoundRobinPolicy>(SchedulePolicy::RoundRobin, *cores, *processes);
+    compare_tracing<CompletelyFairPolicy>(SchedulePolicy::CompletelyFair, *cores, *processes);
+}
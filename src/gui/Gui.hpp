@@ -628,6 +628,25 @@ void combo(const std::string& name, const std::span<const Enum> values, Enum cur
     }
 }
 
+// Slider over [min, max] taking the whole available width, calling `callback(value)` whenever it is moved
+template<std::invocable<std::size_t> Callback>
+void slider(
+  const std::string& name,
+  const std::size_t  value,
+  const std::size_t  min,
+  const std::size_t  max,
+  Callback&&         callback
+)
+{
+    static_assert(sizeof(std::size_t) == sizeof(ImU64), "sliders are drawn over 64-bit values");
+
+    auto current = value;
+    ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+    if (ImGui::SliderScalar(name.c_str(), ImGuiDataType_U64, &current, &min, &max)) {
+        std::invoke(std::forward<Callback>(callback), current);
+    }
+}
+
 namespace Plotting
 {
 
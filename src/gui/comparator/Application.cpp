@@ -21,8 +21,13 @@
 {
     std::unordered_map<std::string, std::vector<double>> result;
 
+    // NOTE: results saved by older builds lack some keys, like the percentiles, only the shared ones are compared
+    const auto in_every_table = [&](const auto& key) {
+        return std::ranges::all_of(tables, [&](const auto& table) { return table.contains(key); });
+    };
+
     const auto keys = valid_keys(tables.front() | std::views::keys);
-    for (const auto& key : keys) {
+    for (const auto& key : keys | std::views::filter(in_every_table)) {
         std::vector<double> values;
         for (const auto& table : tables) {
             const auto parse_result = Util::parse_double(table.at(key));
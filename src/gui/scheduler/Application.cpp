@@ -1,43 +1,60 @@
 #include "Application.hpp"
 
-#include <numeric>
-
-static void draw_events_table(const Os::Process::EventsQueue& events)
+#include "simulations/Report.hpp"
+
+// NOTE: the duration shown for the current event is what is left of it, `current_remaining` when given
+static void draw_events_table(
+  const Simulations::Scheduler&               sim,
+  const Simulations::Scheduler::ProcessHandle handle,
+  const std::optional<std::size_t>            current_remaining = std::nullopt
+)
 {
     constexpr static auto TABLE_NAME  = "##EventsTable";
     constexpr static auto HEADERS     = { "Event", "Duration", "Resource Usage" };
     constexpr static auto TABLE_FLAGS = Gui::TableFlags::Borders | Gui::TableFlags::RowBackground;
 
-    if (!events.empty()) {
+    if (sim.has_events(handle)) {
         Gui::draw_table(TABLE_NAME, HEADERS, TABLE_FLAGS, [&] {
-            std::ranges::for_each(events, [](const auto& event) {
+            const auto current = sim.current_event(handle);
+            for (auto idx = current; idx < sim.process(handle).events.end(); ++idx) {
+                const auto event    = sim.event_pool.event(idx);
+                const auto duration = idx == current ? current_remaining.value_or(sim.arena.remainings[handle])
+                                                     : event.duration;
                 Gui::draw_table_row(
                   [&] { Gui::text("{}", event.kind); },
-                  [&] { Gui::text("{}", event.duration); },
+                  [&] { Gui::text("{}", duration); },
                   [&] { Gui::text("{}%", std::lround(event.resource_usage * 100)); }
                 );
-            });
+            }
         });
     }
 }
 
-static void draw_process(const auto& process)
+static void draw_process(
+  const Simulations::Scheduler&               sim,
+  const Simulations::Scheduler::ProcessHandle handle,
+  const std::optional<std::size_t>            current_remaining = std::nullopt
+)
 {
-    if (process == nullptr) { return; }
-
-    auto header_title = std::format("{} #{}", process->name, process->pid);
+    const auto& process      = sim.process(handle);
+    auto        header_title = std::format("{} #{}", process.name, process.pid);
     Gui::collapsing(header_title, Gui::TreeNodeFlags::DefaultOpen, [&] {
-        if (process->name != "Process") { header_title = std::string { process->name }; }
-        Gui::text("Pid: {}", process->pid);
-        Gui::text("Arrival Time: {}", process->arrival);
-        draw_events_table(process->events);
+        if (process.name != "Process") { header_title = std::string { process.name }; }
+        Gui::text("Pid: {}", process.pid);
+        Gui::text("Arrival Time: {}", process.arrival);
+        draw_events_table(sim, handle, current_remaining);
     });
 }
 
-static void draw_process_queue(const std::string& title, const auto& processes, const ImVec2& child_size)
+static void draw_process_queue(
+  const std::string&            title,
+  const Simulations::Scheduler& sim,
+  auto&&                        handles,
+  const ImVec2&                 child_size
+)
 {
     Gui::title(title, child_size, [&] {
-        std::ranges::for_each(processes, [](const auto& process) { draw_process(process); });
+        std::ranges::for_each(handles, [&](const auto handle) { draw_process(sim, handle); });
     });
 }
 
@@ -61,18 +78,14 @@ void Application::render()
 
         if (ImGui::IsKeyPressed(ImGuiKey_Enter, false)) { should_finish = !should_finish; }
 
-        if (!sim->complete() && should_finish && !stepped_this_frame) {
-            sim->step();
-            stepped_this_frame = true;
-        }
+        if (!sim->complete() && should_finish && !stepped_this_frame) { step_simulation(); }
 
         if (ImGui::IsKeyPressed(ImGuiKey_Space, false)) {
-            if (!sim->complete() && !stepped_this_frame) {
-                sim->step();
-                stepped_this_frame = true;
-            }
+            if (!sim->complete() && !stepped_this_frame) { step_simulation(); }
         }
 
+        if (ImGui::IsKeyPressed(ImGuiKey_Backspace, false) && sim->timer > 0) { seek(sim->timer - 1); }
+
         glfwPollEvents();
         if (glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0) { continue; }
 
@@ -95,11 +108,26 @@ void Application::render()
 
               draw_scheduler_policy_picker();
 
+              draw_timeline();
+
               const std::array<Gui::IndexGridCallback, 6> drawables = {
-                  [&](const auto& size) { draw_process_queue("Ready", std::views::join(sim->ready), size); },
-                  [&](const auto& size) { draw_process_queue("Waiting", std::views::join(sim->waiting), size); },
+                  [&](const auto& size) {
+                      if (sim->global_run_queue()) {
+                          draw_process_queue("Ready", *sim, sim->shared_ready.values(), size);
+                          return;
+                      }
+
+                      const auto values = [](const auto& core) { return core.ready.values(); };
+                      auto       ready  = sim->cores | std::views::transform(values) | std::views::join;
+                      draw_process_queue("Ready", *sim, ready, size);
+                  },
+                  [&](const auto& size) { draw_waiting_queue(size); },
                   [&](const auto& size) { draw_running_process(size); },
-                  [&](const auto& size) { draw_process_queue("Arrival", std::views::join(sim->processes), size); },
+                  [&](const auto& size) {
+                      const auto values   = [](const auto& core) { return core.arrivals.values(); };
+                      auto       arrivals = sim->cores | std::views::transform(values) | std::views::join;
+                      draw_process_queue("Arrival", *sim, arrivals, size);
+                  },
                   [&](const auto& size) { draw_graphs(size); },
                   [&](const auto& size) { draw_statistics(size); }
               };
@@ -133,20 +161,7 @@ void Application::draw_save_button() const
             return;
         }
 
-        std::stringstream ss;
-        ss << std::format("timer = {}\n", sim->timer);
-        ss << std::format("schedule_policy = {}\n", sim->schedule_policy.name());
-
-        ss << "separator\n";
-
-        ss << std::format("avg_waiting_time = {}\n", sim->average_waiting_time());
-        ss << std::format("max_waiting_time = {}\n", max_waiting_time);
-        ss << std::format("avg_turnaround_time = {}\n", sim->average_turnaround_time());
-        ss << std::format("max_turnaround_time = {}\n", max_turnaround_time);
-        ss << std::format("avg_throughput = {:.2f}\n", sim->throughput);
-        ss << std::format("max_throughput = {:.2f}\n", max_throughput);
-
-        Util::write_to_file(file_path.value(), ss.str());
+        Util::write_to_file(file_path.value(), Simulations::format_report(*sim, peaks));
         Gui::toast(
           std::format("Saved simulation result to {}", file_path.value()),
           Gui::ToastPosition::BottomRight,
@@ -164,22 +179,17 @@ void Application::draw_save_button() const
 
 void Application::draw_control_buttons()
 {
-    constexpr static auto BUTTONS_COUNT = 3;
+    constexpr static auto BUTTONS_COUNT = 4;
     Gui::center_content_horizontally(BUTTON_SIZE.x * BUTTONS_COUNT);
 
     const auto restart_callback = [this] {
         sim->restart();
         should_finish      = false;
         stepped_this_frame = false;
-        delta_time         = 0.0F;
-        cpu_usage_buffer.clear();
-        average_waiting_time_buffer.clear();
-        max_waiting_time = 0;
-        average_turnaround_time_buffer.clear();
-        max_turnaround_time = 0;
-        cpu_usage_buffer.clear();
-        throughput_buffer.clear();
-        max_throughput = 0;
+        clear_plots();
+        peaks = {};
+        timeline.clear();
+        timeline.record(*sim, peaks);
     };
 
     Gui::enabled_if(sim->complete(), [&] {
@@ -189,6 +199,12 @@ void Application::draw_control_buttons()
 
     ImGui::SameLine();
 
+    Gui::enabled_if(sim->timer > 0, [&] {
+        Gui::image_button(previous_texture, BUTTON_SIZE, "[Backspace] Previous", [this] { seek(sim->timer - 1); });
+    });
+
+    ImGui::SameLine();
+
     Gui::image_button(play_texture, BUTTON_SIZE, "[Enter] Play", [this] {
         if (!sim->complete()) { should_finish = !should_finish; }
     });
@@ -196,40 +212,98 @@ void Application::draw_control_buttons()
     ImGui::SameLine();
 
     Gui::image_button(next_texture, BUTTON_SIZE, "[Space] Next", [this] {
-        if (!sim->complete()) { sim->step(); }
+        if (!sim->complete()) { step_simulation(); }
     });
 }
 
+void Application::draw_timeline()
+{
+    const auto last_tick = std::max(timeline.last_tick(), sim->timer);
+    Gui::slider("##Timeline", sim->timer, 0, last_tick, [this](const std::size_t tick) { seek(tick); });
+}
+
+void Application::step_simulation()
+{
+    sim->step();
+    peaks.sample(*sim);
+    timeline.record(*sim, peaks);
+    stepped_this_frame = true;
+}
+
+// NOTE: restores the last keyframe before `tick` and steps from there, so the cost is bounded by the keyframe period
+void Application::seek(const std::size_t tick)
+{
+    should_finish = false;
+    clear_plots();
+    if (!timeline.seek(*sim, tick, [this] { peaks.sample(*sim); }, peaks)) {
+        Gui::toast(
+          std::format("Failed to seek to tick {}", tick),
+          Gui::ToastPosition::BottomRight,
+          std::chrono::seconds(3),
+          Gui::ToastLevel::Error
+        );
+    }
+}
+
+// NOTE: the plots are a history of the frames the simulation was stepped in, which a seek no longer follows
+void Application::clear_plots()
+{
+    delta_time = 0.0F;
+    cpu_usage_buffer.clear();
+    average_waiting_time_buffer.clear();
+    average_turnaround_time_buffer.clear();
+    throughput_buffer.clear();
+}
+
 void Application::draw_scheduler_policy_picker()
 {
     // FIXME: Mind that the order here matters, you have to declare these in the same way they are
     // declared in the enum. Is kinda sus but i don't see how to fix this rn.
     constexpr static auto ITEMS =
-      std::array<Simulations::SchedulePolicy, 2> { Simulations::SchedulePolicy::FirstComeFirstServed,
-                                                   Simulations::SchedulePolicy::RoundRobin };
+      std::array<Simulations::SchedulePolicy, 6> { Simulations::SchedulePolicy::FirstComeFirstServed,
+                                                   Simulations::SchedulePolicy::RoundRobin,
+                                                   Simulations::SchedulePolicy::ShortestJobFirst,
+                                                   Simulations::SchedulePolicy::ShortestRemainingTimeFirst,
+                                                   Simulations::SchedulePolicy::MultiLevelFeedbackQueue,
+                                                   Simulations::SchedulePolicy::CompletelyFair };
 
     Gui::combo(
       "##SchedulePolicyPicker",
       std::span(ITEMS.begin(), ITEMS.end()),
       sim->schedule_policy.kind(),
-      [&](const auto& selected) { sim->switch_schedule_policy(Simulations::named_scheduler_from_policy(selected)); }
+      [&](const auto& selected) {
+          sim->switch_schedule_policy(Simulations::named_scheduler_from_policy(selected));
+          timeline.branch(*sim, peaks);
+      }
     );
 }
 
 
+void Application::draw_waiting_queue(const ImVec2& child_size) const
+{
+    Gui::title("Waiting", child_size, [&] {
+        const auto waiting =
+          sim->cores | std::views::transform(&Simulations::Scheduler::Core::waiting) | std::views::join;
+        std::ranges::for_each(waiting, [&](const auto& entry) {
+            draw_process(*sim, entry.value, sim->remaining_io_duration(entry));
+        });
+    });
+}
+
 void Application::draw_running_process(const ImVec2& child_size) const
 {
-    Gui::grid(sim->threads_count, child_size, [&](const auto& elem_size, const auto& idx) {
-        const auto running = sim->running[idx];
-        const auto title   = std::format("CPU Core #{}", idx);
+    Gui::grid(sim->threads_count(), child_size, [&](const auto& elem_size, const auto& idx) {
+        const auto slot  = sim->cores[idx].running;
+        const auto title = std::format("CPU Core #{}", idx);
 
         Gui::title(title, elem_size, [&] {
-            if (running != nullptr) {
-                const auto name = std::string { running->name };
-                Gui::collapsing(std::format("{} {}", name, running->pid), Gui::TreeNodeFlags::DefaultOpen, [&] {
-                    Gui::text("Pid: {}", running->pid);
-                    Gui::text("Arrival Time: {}", running->arrival);
-                    draw_events_table(running->events);
+            if (slot.has_value()) {
+                const auto& running = sim->process(*slot);
+                const auto  name    = std::string { running.name };
+                Gui::collapsing(std::format("{} {}", name, running.pid), Gui::TreeNodeFlags::DefaultOpen, [&] {
+                    Gui::text("Pid: {}", running.pid);
+                    Gui::text("Arrival Time: {}", running.arrival);
+                    draw_events_table(*sim, *slot);
                 });
             }
         });
@@ -281,18 +355,16 @@ void Application::draw_throughput_graph(const ImVec2& child_size)
         .x_min        = delta_time - PLOT_HISTORY,
         .x_max        = delta_time,
         .y_min        = 0,
-        .y_max        = max_throughput,
+        .y_max        = peaks.throughput,
         .color        = ImPlot::GetColormapColor(3),
         .line_weight  = 2.5F,
         .scrollable   = sim->complete(),
     };
 
-    const auto new_value = sim->throughput;
-    if (!sim->complete()) { throughput_buffer.emplace_point(delta_time, static_cast<float>(new_value)); }
+    if (!sim->complete()) { throughput_buffer.emplace_point(delta_time, static_cast<float>(sim->throughput)); }
 
     Gui::title("Throughput", child_size, [&](const auto& remaining_size) {
-        max_throughput  = std::max(max_throughput, new_value);
-        plot_opts.y_max = max_throughput;
+        plot_opts.y_max = peaks.throughput;
 
         Gui::Plotting::plot("##ThroughputPlot", remaining_size, plot_opts, [&] {
             Gui::Plotting::line("throughput", throughput_buffer, Gui::Plotting::LineFlags::None);
@@ -308,7 +380,7 @@ void Application::draw_average_waiting_time_graph(const ImVec2& child_size)
         .x_min        = delta_time - PLOT_HISTORY,
         .x_max        = delta_time,
         .y_min        = 0,
-        .y_max        = static_cast<double>(max_waiting_time),
+        .y_max        = static_cast<double>(peaks.waiting_time),
         .color        = ImPlot::GetColormapColor(7),
         .line_weight  = 2.5F,
         .scrollable   = sim->complete(),
@@ -318,8 +390,7 @@ void Application::draw_average_waiting_time_graph(const ImVec2& child_size)
     if (!sim->complete()) { average_waiting_time_buffer.emplace_point(delta_time, static_cast<float>(new_value)); }
 
     Gui::title("Waiting time", child_size, [&](const auto& remaining_size) {
-        max_waiting_time = std::max(max_waiting_time, new_value);
-        plot_opts.y_max  = static_cast<double>(std::max(max_waiting_time, 1UL) + 5);
+        plot_opts.y_max = static_cast<double>(std::max(peaks.waiting_time, 1UL) + 5);
 
         Gui::Plotting::plot("##WaitingTimePlot", remaining_size, plot_opts, [&] {
             Gui::Plotting::line("waiting time", average_waiting_time_buffer, Gui::Plotting::LineFlags::None);
@@ -335,7 +406,7 @@ void Application::draw_average_turnaround_time_graph(const ImVec2& child_size)
         .x_min        = delta_time - PLOT_HISTORY,
         .x_max        = delta_time,
         .y_min        = 0,
-        .y_max        = static_cast<double>(max_turnaround_time),
+        .y_max        = static_cast<double>(peaks.turnaround_time),
         .x_label      = std::nullopt,
         .y_label      = std::nullopt,
         .color        = ImPlot::GetColormapColor(2),
@@ -347,8 +418,7 @@ void Application::draw_average_turnaround_time_graph(const ImVec2& child_size)
     if (!sim->complete()) { average_turnaround_time_buffer.emplace_point(delta_time, static_cast<float>(new_value)); }
 
     Gui::title("Turnaround time", child_size, [&](const auto& remaining_size) {
-        max_turnaround_time = std::max(max_turnaround_time, new_value);
-        plot_opts.y_max     = static_cast<double>(std::max(max_turnaround_time, 1UL) + 5);
+        plot_opts.y_max = static_cast<double>(std::max(peaks.turnaround_time, 1UL) + 5);
 
         Gui::Plotting::plot("##TurnaroundTimePlot", remaining_size, plot_opts, [&] {
             Gui::Plotting::line("turnaround time", average_turnaround_time_buffer, Gui::Plotting::LineFlags::None);
@@ -369,6 +439,8 @@ void Application::draw_statistics(const ImVec2& child_size) const
 
             draw_key_value("Timer", sim->timer);
             draw_key_value("Scheduler Policy", sim->schedule_policy.name());
+            draw_key_value("Migrations", sim->migrations);
+            draw_key_value("Timeline memory", std::format("{} KiB", timeline.memory_usage() / 1024));
         });
 
         ImGui::Separator();
@@ -379,15 +451,11 @@ void Application::draw_statistics(const ImVec2& child_size) const
                 Gui::draw_table_row([&] { Gui::text("{}", key); }, [&] { Gui::text("{}", value); });
             };
 
-            const auto calculate_size = [](const auto& queues) -> std::size_t {
-                return std::accumulate(queues.begin(), queues.end(), 0UL, [](const auto& acc, const auto& queue) {
-                    return acc + queue.size();
-                });
-            };
-
-            draw_key_value("Ready queue size", calculate_size(sim->ready));
-            draw_key_value("Waiting queue size", calculate_size(sim->waiting));
-            draw_key_value("Arrival size", calculate_size(sim->processes));
+            draw_key_value("Ready queue size", sim->population.ready);
+            draw_key_value("Waiting queue size", sim->population.waiting);
+            draw_key_value("Arrival size", sim->population.arriving);
+            draw_key_value("Running", sim->population.running);
+            draw_key_value("Finished", sim->population.finished);
         });
 
         ImGui::Separator();
@@ -398,10 +466,8 @@ void Application::draw_statistics(const ImVec2& child_size) const
                 Gui::draw_table_row([&] { Gui::text("{}", key); }, [&] { Gui::text("{}%", value); });
             };
 
-            for (std::size_t thread_idx = 0; thread_idx < sim->threads_count; ++thread_idx) {
-                draw_key_value(
-                  std::format("Core #{}", thread_idx), static_cast<std::size_t>(sim->cpu_usage[thread_idx] * 100)
-                );
+            for (const auto& [thread_idx, core] : std::views::zip(std::views::iota(0UL), sim->cores)) {
+                draw_key_value(std::format("Core #{}", thread_idx), static_cast<std::size_t>(core.cpu_usage * 100));
             }
         });
 
@@ -424,11 +490,29 @@ void Application::draw_statistics(const ImVec2& child_size) const
             };
 
             draw_key_value("Avg. waiting time", sim->average_waiting_time());
-            draw_key_value("Max. waiting time", max_waiting_time);
+            draw_key_value("Max. waiting time", peaks.waiting_time);
             draw_key_value("Avg. turnaround time", sim->average_turnaround_time());
-            draw_key_value("Max. turnaround time", max_turnaround_time);
+            draw_key_value("Max. turnaround time", peaks.turnaround_time);
+            draw_key_value("Shortest waiting time", sim->waiting_times.min());
+            draw_key_value("Longest waiting time", sim->waiting_times.max());
+            draw_key_value("Shortest turnaround time", sim->turnaround_times.min());
+            draw_key_value("Longest turnaround time", sim->turnaround_times.max());
             draw_key_value("Avg. throughput", sim->throughput);
-            draw_key_value("Max. throughput", max_throughput);
+            draw_key_value("Max. throughput", peaks.throughput);
+        });
+
+        ImGui::Separator();
+
+        constexpr static auto LATENCY_TABLE_HEADERS = { "Percentile", "Waiting", "Turnaround", "Response" };
+        Gui::draw_table("LatencyTable", LATENCY_TABLE_HEADERS, TABLE_FLAGS, [&] {
+            for (const auto& [label, quantile] : Simulations::REPORTED_PERCENTILES) {
+                Gui::draw_table_row(
+                  [&] { Gui::text("{}", label); },
+                  [&] { Gui::text("{}", sim->waiting_time_histogram.percentile(quantile)); },
+                  [&] { Gui::text("{}", sim->turnaround_time_histogram.percentile(quantile)); },
+                  [&] { Gui::text("{}", sim->response_time_histogram.percentile(quantile)); }
+                );
+            }
         });
     });
 }
@@ -437,10 +521,13 @@ Application::Application(GLFWwindow* window, const std::shared_ptr<Simulations::
   : window { window },
     sim { sim },
     restart_texture { Gui::Texture::load_from_file("resources/restart.png") },
+    previous_texture { Gui::Texture::load_from_file("resources/previous.png") },
     play_texture { Gui::Texture::load_from_file("resources/play.png") },
     next_texture { Gui::Texture::load_from_file("resources/next.png") },
     save_texture { Gui::Texture::load_from_file("resources/save.png") }
-{}
+{
+    timeline.record(*sim, peaks);
+}
 
 Application::~Application()
 {
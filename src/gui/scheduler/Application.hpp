@@ -5,7 +5,9 @@
 #include <imgui.h>
 
 #include "gui/Gui.hpp"
+#include "simulations/Report.hpp"
 #include "simulations/Scheduler.hpp"
+#include "simulations/Timeline.hpp"
 
 class [[nodiscard]] Application final
 {
@@ -18,7 +20,9 @@ class [[nodiscard]] Application final
     void draw_save_button() const;
     void draw_control_buttons();
     void draw_scheduler_policy_picker();
+    void draw_timeline();
 
+    void draw_waiting_queue(const ImVec2& child_size) const;
     void draw_running_process(const ImVec2& child_size) const;
     void draw_graphs(const ImVec2& child_size);
     void draw_cpu_usage_graph(const ImVec2& child_size);
@@ -36,6 +40,10 @@ class [[nodiscard]] Application final
   private:
     explicit Application(GLFWwindow* window, const std::shared_ptr<Simulations::Scheduler>& sim);
 
+    void step_simulation();
+    void seek(std::size_t tick);
+    void clear_plots();
+
   private:
     constexpr static auto WINDOW_WIDTH     = 1920;
     constexpr static auto WINDOW_HEIGHT    = 1080;
@@ -50,15 +58,17 @@ class [[nodiscard]] Application final
     bool                                    should_finish      = false;
     bool                                    stepped_this_frame = false;
     Gui::Texture                            restart_texture;
+    Gui::Texture                            previous_texture;
     Gui::Texture                            play_texture;
     Gui::Texture                            next_texture;
     Gui::Texture                            save_texture;
     float                                   delta_time = 0.0F;
     Gui::Plotting::RingBuffer               cpu_usage_buffer;
     Gui::Plotting::RingBuffer               average_waiting_time_buffer;
-    std::size_t                             max_waiting_time = 0;
     Gui::Plotting::RingBuffer               average_turnaround_time_buffer;
-    std::size_t                             max_turnaround_time = 0;
     Gui::Plotting::RingBuffer               throughput_buffer;
-    double                                  max_throughput = 0;
+    Simulations::MetricPeaks                peaks;
+
+    // NOTE: the peaks are kept in the keyframes too, so that they match the tick sought to
+    Simulations::Timeline<Simulations::NamedSchedulePolicy> timeline;
 };
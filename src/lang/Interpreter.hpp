@@ -15,14 +15,19 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <functional>
+#include <map>
 #include <memory>
 #include <print>
 #include <ranges>
+#include <string>
+#include <unordered_set>
 #include <utility>
 
 #include "Lexer.hpp"
 #include "os/Os.hpp"
 #include "Parser.hpp"
+#include "Random.hpp"
 #include "Util.hpp"
 
 namespace Interpreter
@@ -107,11 +112,18 @@ struct [[nodiscard]] Value final
     ValueType value;
 };
 
+// Values of script constants, keyed by name, which take precedence over the ones assigned by the script itself
+using ConstantOverrides = std::map<std::string, std::string, std::less<>>;
+
 template<typename Sim>
 class [[nodiscard]] Interpreter final
 {
   public:
-    [[nodiscard]] static auto eval(const std::string_view file_content, const std::shared_ptr<Sim>& sim) -> bool
+    [[nodiscard]] static auto eval(
+      const std::string_view      file_content,
+      const std::shared_ptr<Sim>& sim,
+      ConstantOverrides           overrides = {}
+    ) -> bool
     {
         const auto tokens = Lexer::lex(file_content);
         if (!tokens) { return false; }
@@ -139,11 +151,22 @@ class [[nodiscard]] Interpreter final
 #endif
 
 
-        Interpreter interpreter(sim, *ast);
+        Interpreter interpreter(sim, *ast, std::move(overrides));
+        if (!interpreter.apply_overrides()) { return false; }
+
         return interpreter.evaluate_ast().has_value();
     }
 
   private:
+    [[nodiscard]] auto apply_overrides() -> bool
+    {
+        for (const auto& [name, value] : overrides) {
+            if (!set_constant(name, value)) { return false; }
+        }
+
+        return true;
+    }
+
     [[nodiscard]] auto evaluate_ast() -> std::optional<bool>
     {
         bool failed = false;
@@ -221,30 +244,14 @@ class [[nodiscard]] Interpreter final
         const auto constant_visitor = [this](const Constant& constant) -> std::optional<Value> {
             const auto name = constant.name.lexeme;
 
+            // NOTE: overridden constants were already set before evaluating the script
+            if (overrides.contains(name)) { return Value(); }
+
             const auto expr = ast.expression_by_id(constant.value);
             if (const auto variable = Util::get<Variable>(expr.kind); variable.has_value()) {
-                if (name == "schedule_policy") {
-                    const auto policy = TRY(Simulations::try_policy_from_str(variable->name.lexeme));
-                    sim->switch_schedule_policy(Simulations::named_scheduler_from_policy(policy));
-                }
+                return set_constant(name, variable->name.lexeme);
             } else if (const auto number = Util::get<Number>(expr.kind); number.has_value()) {
-                if (name == "max_processes") {
-                    sim->max_processes = TRY(Util::parse_number(number->number.lexeme));
-                } else if (name == "max_events_per_process") {
-                    sim->max_events_per_process = TRY(Util::parse_number(number->number.lexeme));
-                } else if (name == "max_single_event_duration") {
-                    sim->max_single_event_duration = TRY(Util::parse_number(number->number.lexeme));
-                } else if (name == "max_arrival_time") {
-                    sim->max_arrival_time = TRY(Util::parse_number(number->number.lexeme));
-                } else if (name == "threads_count") {
-                    sim->threads_count = TRY(Util::parse_number(number->number.lexeme));
-                } else {
-                    report_error("invalid constant for current simulation: {}", name);
-                    report_note(
-                      "available constants are: max_processes, max_events_per_process, max_single_event_duration, "
-                      "max_arrival_time"
-                    );
-                }
+                return set_constant(name, number->number.lexeme);
             }
 
             return Value();
@@ -275,6 +282,62 @@ class [[nodiscard]] Interpreter final
         return std::visit(visitor, expression.kind);
     }
 
+    [[nodiscard]] auto set_constant(const std::string_view name, const std::string_view value) -> std::optional<Value>
+    {
+        if (name == "schedule_policy") {
+            const auto policy = TRY(Simulations::try_policy_from_str(value));
+            sim->switch_schedule_policy(Simulations::named_scheduler_from_policy(policy));
+        } else if (name == "max_processes") {
+            sim->max_processes = TRY(Util::parse_number(value));
+        } else if (name == "max_events_per_process") {
+            sim->max_events_per_process = TRY(Util::parse_number(value));
+        } else if (name == "max_single_event_duration") {
+            sim->max_single_event_duration = TRY(Util::parse_number(value));
+        } else if (name == "max_arrival_time") {
+            sim->max_arrival_time = TRY(Util::parse_number(value));
+        } else if (name == "threads_count") {
+            const auto threads_count = TRY(Util::parse_number(value));
+            if (threads_count == 0) { return report_error("constant `threads_count` must be at least 1"); }
+            if (sim->arena.size() != 0 && threads_count < sim->threads_count()) {
+                return report_error(
+                  "constant `threads_count` cannot drop below {} once processes are spawned", sim->threads_count()
+                );
+            }
+            sim->set_threads_count(threads_count);
+        } else if (name == "host_threads") {
+            const auto host_threads = TRY(Util::parse_number(value));
+            if (host_threads == 0) { return report_error("constant `host_threads` must be at least 1"); }
+            sim->set_host_threads(host_threads);
+        } else if (name == "quantum") {
+            const auto quantum = TRY(Util::parse_number(value));
+            if (quantum == 0) { return report_error("constant `quantum` must be at least 1"); }
+            sim->quantum = quantum;
+        } else if (name == "priority_levels") {
+            const auto levels = TRY(Util::parse_number(value));
+            if (levels == 0 || levels > Sim::MAX_PRIORITY_LEVELS) {
+                return report_error("constant `priority_levels` must be between 1 and {}", Sim::MAX_PRIORITY_LEVELS);
+            }
+            sim->set_priority_levels(levels);
+        } else if (name == "priority_boost_period") {
+            sim->priority_boost_period = TRY(Util::parse_number(value));
+        } else if (name == "seed") {
+            sim->rng.seed(TRY(Util::parse_number(value)));
+        } else if (name == "run_queue") {
+            sim->set_run_queue_mode(TRY(Simulations::try_run_queue_mode_from_str(value)));
+        } else if (name == "steal_threshold") {
+            sim->steal_threshold = TRY(Util::parse_number(value));
+        } else {
+            report_error("invalid constant for current simulation: {}", name);
+            return report_note(
+              "available constants are: schedule_policy, max_processes, max_events_per_process, "
+              "max_single_event_duration, max_arrival_time, threads_count, host_threads, quantum, priority_levels, "
+              "priority_boost_period, seed, run_queue, steal_threshold"
+            );
+        }
+
+        return Value();
+    }
+
     [[nodiscard]] auto evalute_for_expression(const For& four) -> std::optional<Value>
     {
         const auto  range = TRY(Util::get<Range>(ast.expression_by_id(four.range).kind));
@@ -295,10 +358,10 @@ class [[nodiscard]] Interpreter final
         return std::ranges::contains(builtins, token.lexeme);
     }
 
-    [[nodiscard]] auto list_as_events_deque(const std::vector<Value>& list) const
-      -> std::optional<std::deque<Os::Event>>
+    [[nodiscard]] auto list_as_events(const std::vector<Value>& list) -> std::optional<std::vector<Os::Event>>
     {
-        std::deque<Os::Event> events = {};
+        std::vector<Os::Event> events = {};
+        events.reserve(list.size());
         for (const auto& tuple_value : list) {
             const auto tuple = TRY(tuple_value.as_value_list_or([&] -> std::optional<std::vector<Value>> {
                 return report_note("(e.g. [(event_type: `Io` or `Cpu`, duration: int)])");
@@ -317,7 +380,7 @@ class [[nodiscard]] Interpreter final
 
             events.push_back(Os::Event { .kind           = *maybe_event_kind,
                                          .duration       = duration,
-                                         .resource_usage = std::max(0.01F, Util::random_float()) });
+                                         .resource_usage = std::max(0.01F, sim->rng.unit_float()) });
         }
 
         return events;
@@ -327,7 +390,10 @@ class [[nodiscard]] Interpreter final
     {
         constexpr static auto NAME = "spawn_process";
         constexpr static auto ARGC = 4;
-        if (arguments.size() != ARGC) { report_function_call_mismatched_argc(NAME, arguments.size()); }
+        // NOTE: the weight of the process is optional
+        if (arguments.size() != ARGC && arguments.size() != ARGC + 1) {
+            return report_function_call_mismatched_argc(NAME, "4 or 5", arguments.size());
+        }
 
         std::size_t argument_count     = 0;
         const auto  process_name_value = TRY(evaluate_expression(arguments[argument_count++]));
@@ -361,46 +427,62 @@ class [[nodiscard]] Interpreter final
             return report_note("(e.g. [(event_type: `Io` or `Cpu`, duration: int)])");
         }));
 
-        const auto events = TRY(list_as_events_deque(list));
-        sim->emplace_process(process_name, pid, arrival, events);
+        const auto events = TRY(list_as_events(list));
+
+        auto weight = Os::DEFAULT_WEIGHT;
+        if (arguments.size() > ARGC) {
+            const auto weight_value = TRY(evaluate_expression(arguments[argument_count++]));
+            weight                  = TRY(weight_value.as_number_or([&] -> std::optional<std::size_t> {
+                return report_error(
+                  "mismatched type for argument #{} of builting `{}`: expected type `int`", argument_count - 1, NAME
+                );
+            }));
+
+            if (weight == 0 || weight > Sim::MAX_WEIGHT) {
+                return report_error("weight of process {} must be between 1 and {}", process_name, Sim::MAX_WEIGHT);
+            }
+        }
+
+        sim->emplace_process(process_name, pid, arrival, events, weight);
 
         return Value();
     }
 
     [[nodiscard]] auto spawn_random_process_builtin(const std::vector<Expression>& arguments) -> std::optional<Value>
     {
-        static std::vector<std::size_t> spawned_pids;
-
-        constexpr static auto NAME = "spawn_process";
+        constexpr static auto NAME = "spawn_random_process";
         constexpr static auto ARGC = 0;
-        if (arguments.size() != ARGC) { report_function_call_mismatched_argc(NAME, arguments.size()); }
+        if (arguments.size() != ARGC) { report_function_call_mismatched_argc(NAME, "0", arguments.size()); }
 
-        auto pid = Util::random_natural(0, sim->max_processes);
-        while (std::ranges::contains(spawned_pids, pid)) { pid = Util::random_natural(0, sim->max_processes); }
-        spawned_pids.push_back(pid);
+        auto pid = sim->rng.natural(0, sim->max_processes);
+        while (spawned_pids.contains(pid)) { pid = sim->rng.natural(0, sim->max_processes); }
+        spawned_pids.insert(pid);
 
-        const auto arrival = Util::random_natural(0, sim->max_arrival_time);
+        const auto arrival = sim->rng.natural(0, sim->max_arrival_time);
 
-        std::deque<Os::Event> events;
-        const auto            events_count = Util::random_natural(1, sim->max_events_per_process);
-        for (std::size_t i = 0; i < events_count; ++i) { events.push_back(process_random_event()); }
+        // NOTE: the events come from a substream of their own, so the pids and arrivals of the following
+        // processes do not depend on how many events this one has
+        auto                   stream = sim->rng.split();
+        std::vector<Os::Event> events;
+        const auto             events_count = stream.natural(1, sim->max_events_per_process);
+        events.reserve(events_count);
+        for (std::size_t i = 0; i < events_count; ++i) { events.push_back(process_random_event(stream)); }
 
         sim->emplace_process("Process", pid, arrival, events);
 
         return Value();
     }
 
-    [[nodiscard]] auto process_random_event() const -> Os::Event
+    [[nodiscard]] auto process_random_event(Util::Random& stream) const -> Os::Event
     {
-        const auto kind =
-          static_cast<Os::EventKind>(Util::random_natural(0, std::to_underlying(Os::EventKind::Count) - 1));
+        const auto kind = static_cast<Os::EventKind>(stream.natural(0, std::to_underlying(Os::EventKind::Count) - 1));
 
-        const auto duration = Util::random_natural(1, sim->max_single_event_duration);
+        const auto duration = stream.natural(1, sim->max_single_event_duration);
 
         return Os::Event {
             .kind           = kind,
             .duration       = duration,
-            .resource_usage = std::max(0.01F, Util::random_float()),
+            .resource_usage = std::max(0.01F, stream.unit_float()),
         };
     }
 
@@ -415,11 +497,14 @@ class [[nodiscard]] Interpreter final
         return Value();
     }
 
-    static auto report_function_call_mismatched_argc(const std::string_view name, const std::size_t got)
-      -> std::nullopt_t
+    static auto report_function_call_mismatched_argc(
+      const std::string_view name,
+      const std::string_view expected,
+      const std::size_t      got
+    ) -> std::nullopt_t
     {
         return report_error(
-          "failed to interpret call to builtin `{}`: expected 4 arguments, {} were provided", name, got
+          "failed to interpret call to builtin `{}`: expected {} arguments, {} were provided", name, expected, got
         );
     }
 
@@ -446,13 +531,17 @@ class [[nodiscard]] Interpreter final
                | std::ranges::to<std::vector>();
     }
 
-    explicit Interpreter(const std::shared_ptr<Sim>& sim_, Ast ast_)
+    explicit Interpreter(const std::shared_ptr<Sim>& sim_, Ast ast_, ConstantOverrides overrides_)
       : sim { sim_ },
-        ast { std::move(ast_) }
+        ast { std::move(ast_) },
+        overrides { std::move(overrides_) }
     {}
 
     std::shared_ptr<Sim> sim;
     Ast                  ast;
+    ConstantOverrides    overrides;
+
+    std::unordered_set<std::size_t> spawned_pids;
 };
 
 } // namespace Interpreter
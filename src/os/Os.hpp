@@ -1,9 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
-#include <deque>
+#include <cstdint>
+#include <limits>
 #include <print>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include "Util.hpp"
 
@@ -42,17 +46,88 @@ struct [[nodiscard]] Event final
     float       resource_usage;
 };
 
-struct [[nodiscard]] Process final
+struct [[nodiscard]] EventRange final
+{
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+
+    [[nodiscard]] auto end() const -> std::uint32_t { return offset + length; }
+};
+
+// Flat storage for the events of all the processes of a simulation, with one array per field.
+// NOTE: the events as spawned never change, the ticks left to the current event of a process are kept with it
+struct [[nodiscard]] EventPool final
 {
-    using EventsQueue = std::deque<Event>;
+    using Index = std::uint32_t;
+
+    [[nodiscard]] auto append(const std::span<const Event> events) -> EventRange
+    {
+        const auto range = EventRange { .offset = size(), .length = static_cast<std::uint32_t>(events.size()) };
+        for (const auto& event : events) { push_back(event); }
+
+        return range;
+    }
+
+    [[nodiscard]] auto event(const Index idx) const -> Event
+    {
+        return Event { .kind = kinds[idx], .duration = durations[idx], .resource_usage = usages[idx] };
+    }
+
+    [[nodiscard]] auto kind(const Index idx) const -> EventKind { return kinds[idx]; }
+    [[nodiscard]] auto duration(const Index idx) const -> std::size_t { return durations[idx]; }
+    [[nodiscard]] auto resource_usage(const Index idx) const -> float { return usages[idx]; }
+
+    [[nodiscard]] auto size() const -> Index { return static_cast<Index>(kinds.size()); }
+
+    // Whether the pool, as read back from a snapshot, holds as many values in every array
+    [[nodiscard]] auto consistent() const -> bool
+    {
+        return kinds.size() == durations.size() && kinds.size() == usages.size()
+               && kinds.size() <= std::numeric_limits<Index>::max();
+    }
+
+    void clear()
+    {
+        kinds.clear();
+        durations.clear();
+        usages.clear();
+    }
+
+    // NOTE: visits the whole state with `archive(fields...)`, for the snapshots of a simulation
+    void serialize(this auto& self, auto& archive) { archive(self.kinds, self.durations, self.usages); }
+
+  private:
+    void push_back(const Event& event)
+    {
+        kinds.push_back(event.kind);
+        durations.push_back(event.duration);
+        usages.push_back(event.resource_usage);
+    }
+
+    std::vector<EventKind>   kinds;
+    std::vector<std::size_t> durations;
+    std::vector<float>       usages;
+};
 
+// NOTE: weight of a process of nice value 0, as in the Linux scheduler
+constexpr std::size_t DEFAULT_WEIGHT = 1024;
+
+// The workload a process was spawned with, which running it never changes.
+// NOTE: the state of a running process lives in the `ProcessArena` holding it
+struct [[nodiscard]] Process final
+{
     std::string name;
     std::size_t pid;
     std::size_t arrival;
-    EventsQueue events;
+    EventRange  events;
 
-    std::optional<std::size_t> start_time  = std::nullopt;
-    std::optional<std::size_t> finish_time = std::nullopt;
+    // NOTE: for the fair policies, where a process accrues virtual runtime more slowly the heavier it is
+    std::size_t weight = DEFAULT_WEIGHT;
+
+    void serialize(this auto& self, auto& archive)
+    {
+        archive(self.name, self.pid, self.arrival, self.events, self.weight);
+    }
 };
 
 } // namespace Os
@@ -105,117 +180,3 @@ struct std::formatter<Os::Event>
         );
     }
 };
-
-template<>
-struct std::formatter<std::deque<Os::Event>>
-{
-    constexpr auto parse(auto& ctx)
-    {
-        auto       it  = ctx.begin();
-        const auto end = ctx.end();
-
-        if (it != end && *it == 's') {
-            line_mode = LineMode::SingleLine;
-            ++it;
-        } else if (it != end && *it == 'm') {
-            line_mode = LineMode::Multiline;
-            ++it;
-        }
-
-        if (it != end && *it != '}') { throw std::format_error("invalid format"); }
-
-        return it;
-    }
-
-    auto format(const std::deque<Os::Event>& events, auto& ctx) const
-    {
-        switch (line_mode) {
-            case LineMode::Multiline: {
-                std::format_to(ctx.out(), "[\n");
-                for (const auto& event : events) { std::format_to(ctx.out(), "            {},\n", event); }
-                return std::format_to(ctx.out(), "        ]");
-            }
-            case LineMode::SingleLine: {
-                std::format_to(ctx.out(), "[ ");
-                for (const auto& event : events) { std::format_to(ctx.out(), "{}, ", event); }
-                return std::format_to(ctx.out(), "]");
-            }
-        }
-
-        assert(false && "unreachable");
-    }
-
-  private:
-    enum class LineMode : std::uint8_t
-    {
-        SingleLine = 0,
-        Multiline,
-    };
-
-    LineMode line_mode = LineMode::Multiline;
-};
-
-template<>
-struct std::formatter<Os::Process>
-{
-    constexpr auto parse(auto& ctx)
-    {
-        auto       it  = ctx.begin();
-        const auto end = ctx.end();
-
-        if (it != end && *it == 's') {
-            line_mode = LineMode::SingleLine;
-            ++it;
-        } else if (it != end && *it == 'm') {
-            line_mode = LineMode::Multiline;
-            ++it;
-        }
-
-        if (it != end && *it != '}') { throw std::format_error("invalid format"); }
-
-        return it;
-    }
-
-    auto format(const Os::Process& process, auto& ctx) const
-    {
-        switch (line_mode) {
-            case LineMode::Multiline: {
-                return std::format_to(
-                  ctx.out(),
-                  "Process {{\n        name: {},\n        pid: {},\n        arrival: {},\n        events: {}\n        "
-                  "waiting time: {}\n        turnaround time: {}\n    }}",
-                  process.name,
-                  process.pid,
-                  process.arrival,
-                  process.events,
-                  process.start_time.has_value() ? *process.start_time - process.arrival : 0,
-                  process.finish_time.has_value() ? *process.finish_time - process.arrival : 0
-                );
-            }
-            case LineMode::SingleLine: {
-                return std::format_to(
-                  ctx.out(),
-                  "Process {{ name: {}, pid: {}, arrival: {}, events: {:s}, waiting time: {}, turnaround time: {} }}",
-                  process.name,
-                  process.pid,
-                  process.arrival,
-                  process.events,
-                  process.start_time.has_value() ? *process.start_time - process.arrival : 0,
-                  process.finish_time.has_value() ? *process.finish_time - process.arrival : 0
-                );
-            }
-        }
-
-        assert(false && "unreachable");
-    }
-
-
-  private:
-    enum class LineMode : std::uint8_t
-    {
-        SingleLine = 0,
-        Multiline,
-    };
-
-    LineMode line_mode = LineMode::Multiline;
-};
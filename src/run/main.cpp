@@ -0,0 +1,153 @@
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <print>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "lang/Interpreter.hpp"
+#include "simulations/Report.hpp"
+#include "simulations/Scheduler.hpp"
+#include "simulations/Snapshot.hpp"
+
+namespace
+{
+
+struct [[nodiscard]] Options final
+{
+    std::filesystem::path                script_path;
+    std::optional<std::filesystem::path> results_path;
+
+    // NOTE: the snapshot is overwritten every `checkpoint_period` ticks, so a crashed run can be resumed from it
+    std::optional<std::filesystem::path> checkpoint_path;
+    std::size_t                          checkpoint_period = 0;
+
+    std::optional<std::filesystem::path> resume_path;
+    std::optional<std::filesystem::path> trace_path;
+};
+
+void usage()
+{
+    std::println(
+      "usage: sim-run <file.sl> [results.txt] [--checkpoint <file.snap> <ticks>] [--resume <file.snap>] "
+      "[--trace <file.trace>]"
+    );
+}
+
+[[nodiscard]] auto parse_options(const std::span<const char*> args) -> std::optional<Options>
+{
+    Options                            options;
+    std::vector<std::filesystem::path> positionals;
+
+    for (std::size_t idx = 1; idx < args.size(); ++idx) {
+        const std::string_view arg = args[idx];
+        if (arg == "--checkpoint") {
+            if (idx + 2 >= args.size()) {
+                std::println(stderr, "[ERROR] expected snapshot path and period after --checkpoint");
+                return std::nullopt;
+            }
+
+            options.checkpoint_path   = args[++idx];
+            options.checkpoint_period = TRY(Util::parse_number(args[++idx]));
+            if (options.checkpoint_period == 0) {
+                std::println(stderr, "[ERROR] checkpoint period must be at least 1 tick");
+                return std::nullopt;
+            }
+        } else if (arg == "--resume") {
+            if (idx + 1 >= args.size()) {
+                std::println(stderr, "[ERROR] expected snapshot path after --resume");
+                return std::nullopt;
+            }
+
+            options.resume_path = args[++idx];
+        } else if (arg == "--trace") {
+            if (idx + 1 >= args.size()) {
+                std::println(stderr, "[ERROR] expected trace path after --trace");
+                return std::nullopt;
+            }
+
+            options.trace_path = args[++idx];
+        } else {
+            positionals.emplace_back(arg);
+        }
+    }
+
+    if (positionals.empty() || positionals.size() > 2) {
+        std::println(stderr, "[ERROR] expected file path to simulation script");
+        return std::nullopt;
+    }
+
+    options.script_path = positionals[0];
+    if (positionals.size() > 1) { options.results_path = positionals[1]; }
+
+    return options;
+}
+
+} // namespace
+
+auto main(int argc, const char** argv) -> int
+{
+    const auto maybe_options = parse_options(std::span(argv, static_cast<std::size_t>(argc)));
+    if (!maybe_options) {
+        usage();
+        return 1;
+    }
+
+    const auto& options              = *maybe_options;
+    const auto  maybe_script_content = Util::read_entire_file(options.script_path);
+    if (!maybe_script_content) { return 1; }
+
+    using namespace Simulations;
+    auto sim = std::make_shared<Scheduler>(named_scheduler_from_policy(SchedulePolicy::RoundRobin));
+    if (!Interpreter::Interpreter<Scheduler>::eval(*maybe_script_content, sim)) {
+        std::println(stderr, "[ERROR] Could not correctly evaluate script {}", options.script_path.string());
+        return 1;
+    }
+
+    // NOTE: none of the averages grows during the ticks skipped by `step_to_next_event`, so no peak is missed
+    MetricPeaks peaks;
+
+    // NOTE: the script still runs first, for the settings of the host which are not part of the snapshot
+    if (options.resume_path) {
+        const auto snapshot = read_snapshot_file(*options.resume_path);
+        if (!snapshot || !load_snapshot(*sim, *snapshot, peaks)) { return 1; }
+    }
+
+    if (options.trace_path) {
+        if (sim->threads_count() > TRACE_MAX_CORES) {
+            std::println(stderr, "[ERROR] (trace) unable to trace more than {} cores", TRACE_MAX_CORES);
+            return 1;
+        }
+
+        sim->trace = TraceFile::create(*options.trace_path);
+        if (!sim->trace) { return 1; }
+    }
+
+    std::vector<std::byte> snapshot;
+    auto                   next_checkpoint = sim->timer + options.checkpoint_period;
+    while (!sim->complete()) {
+        sim->step_to_next_event();
+        peaks.sample(*sim);
+
+        if (options.checkpoint_path && sim->timer >= next_checkpoint) {
+            save_snapshot(*sim, snapshot, peaks);
+            if (!write_snapshot_file(*options.checkpoint_path, snapshot)) { return 1; }
+            next_checkpoint = sim->timer + options.checkpoint_period;
+        }
+    }
+
+    // NOTE: closing the trace cuts the file down to its records
+    const auto traced = !sim->trace || !sim->trace->failed();
+    sim->trace.reset();
+    if (!traced) { return 1; }
+
+    const auto report = format_report(*sim, peaks);
+    if (!options.results_path) {
+        std::print("{}", report);
+        return 0;
+    }
+
+    Util::write_to_file(*options.results_path, report);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Simulations
+{
+
+// Bucketed calendar of the entries that still have to arrive, keyed by arrival tick.
+// Entries sharing the same tick are kept in insertion order.
+// NOTE: taking the entries of a tick only moves past it, so the calendar can be rewound to replay the arrivals
+template<typename T>
+struct [[nodiscard]] ArrivalCalendar final
+{
+    using Bucket = std::vector<T>;
+
+    void push(const std::size_t tick, T value)
+    {
+        buckets[tick].push_back(std::move(value));
+        ++total;
+        if (tick >= next) { ++count; }
+    }
+
+    // All the entries arriving at `tick`, which must not be earlier than the last tick taken
+    [[nodiscard]] auto take(const std::size_t tick) -> std::span<const T>
+    {
+        assert(tick >= next && "arrivals must be taken in tick order");
+        next = tick + 1;
+
+        const auto it = buckets.find(tick);
+        if (it == buckets.end()) { return {}; }
+
+        count -= it->second.size();
+        return it->second;
+    }
+
+    // First tick not earlier than `from` at which some entry arrives
+    [[nodiscard]] auto next_tick(const std::size_t from) const -> std::optional<std::size_t>
+    {
+        const auto it = buckets.lower_bound(std::max(from, next));
+        if (it == buckets.end()) { return std::nullopt; }
+
+        return it->first;
+    }
+
+    [[nodiscard]] auto values() const
+    {
+        return std::ranges::subrange(buckets.lower_bound(next), buckets.end()) | std::views::values
+               | std::views::join;
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return count; }
+    [[nodiscard]] auto empty() const -> bool { return count == 0; }
+
+    // Makes every entry arrive again
+    void rewind()
+    {
+        next  = 0;
+        count = total;
+    }
+
+    void clear()
+    {
+        buckets.clear();
+        next  = 0;
+        count = 0;
+        total = 0;
+    }
+
+    // Whether the calendar, as read back from a snapshot, was taken from up to `now` at most, counts its entries right
+    // and holds only values accepted by `valid_value`
+    [[nodiscard]] auto consistent(const std::size_t now, const auto& valid_value) const -> bool
+    {
+        std::size_t untaken = 0;
+        std::size_t entries = 0;
+        for (const auto& [tick, bucket] : buckets) {
+            if (!std::ranges::all_of(bucket, valid_value)) { return false; }
+
+            entries += bucket.size();
+            if (tick >= next) { untaken += bucket.size(); }
+        }
+
+        return next <= now && untaken == count && entries == total;
+    }
+
+    void serialize(this auto& self, auto& archive) { archive(self.buckets, self.next, self.count, self.total); }
+
+  private:
+    std::map<std::size_t, Bucket> buckets;
+
+    // NOTE: first tick whose entries were not taken yet
+    std::size_t next  = 0;
+    std::size_t count = 0;
+    std::size_t total = 0;
+};
+
+} // namespace Simulations
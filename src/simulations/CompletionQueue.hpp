@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Simulations
+{
+
+// Min-heap of entries keyed on the absolute tick at which they complete.
+// Entries completing on the same tick are popped in insertion order.
+template<typename T>
+struct [[nodiscard]] CompletionQueue final
+{
+    struct [[nodiscard]] Entry final
+    {
+        std::size_t completion;
+        std::size_t sequence;
+        T           value;
+    };
+
+    void push(const std::size_t completion, T value)
+    {
+        entries.push_back(Entry { .completion = completion, .sequence = next_sequence++, .value = std::move(value) });
+        std::ranges::push_heap(entries, later);
+    }
+
+    [[nodiscard]] auto due(const std::size_t tick) const -> bool
+    {
+        return !entries.empty() && entries.front().completion <= tick;
+    }
+
+    [[nodiscard]] auto pop() -> T
+    {
+        assert(!entries.empty() && "completion queue must not be empty");
+        std::ranges::pop_heap(entries, later);
+        auto value = std::move(entries.back().value);
+        entries.pop_back();
+        return value;
+    }
+
+    [[nodiscard]] auto next_completion() const -> std::size_t
+    {
+        assert(!entries.empty() && "completion queue must not be empty");
+        return entries.front().completion;
+    }
+
+    // NOTE: iteration follows the heap layout, not the completion order
+    [[nodiscard]] auto begin() const { return entries.begin(); }
+    [[nodiscard]] auto end() const { return entries.end(); }
+
+    [[nodiscard]] auto size() const -> std::size_t { return entries.size(); }
+    [[nodiscard]] auto empty() const -> bool { return entries.empty(); }
+
+    void clear()
+    {
+        entries.clear();
+        next_sequence = 0;
+    }
+
+    // Whether the queue, as read back from a snapshot, is still a heap of values accepted by `valid_value`
+    [[nodiscard]] auto consistent(const auto& valid_value) const -> bool
+    {
+        const auto valid_entry = [&](const Entry& entry) {
+            return entry.sequence < next_sequence && valid_value(entry.value);
+        };
+
+        return std::ranges::is_heap(entries, later) && std::ranges::all_of(entries, valid_entry);
+    }
+
+    void serialize(this auto& self, auto& archive) { archive(self.entries, self.next_sequence); }
+
+  private:
+    constexpr static auto later = [](const Entry& lhs, const Entry& rhs) {
+        return std::pair { lhs.completion, lhs.sequence } > std::pair { rhs.completion, rhs.sequence };
+    };
+
+    std::vector<Entry> entries;
+    std::size_t        next_sequence = 0;
+};
+
+} // namespace Simulations
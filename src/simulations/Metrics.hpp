@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace Simulations
+{
+
+// Running sum and bounds of a metric of the finished processes, updated in O(1) per sample
+struct [[nodiscard]] RunningTotal final
+{
+    void push(const std::size_t value)
+    {
+        sum += value;
+        ++samples;
+        lowest  = std::min(lowest, value);
+        highest = std::max(highest, value);
+    }
+
+    [[nodiscard]] auto total() const -> std::size_t { return sum; }
+    [[nodiscard]] auto min() const -> std::size_t { return samples != 0 ? lowest : 0; }
+    [[nodiscard]] auto max() const -> std::size_t { return highest; }
+
+    void clear() { *this = RunningTotal {}; }
+
+    void serialize(this auto& self, auto& archive) { archive(self.sum, self.samples, self.lowest, self.highest); }
+
+  private:
+    std::size_t sum     = 0;
+    std::size_t samples = 0;
+    std::size_t lowest  = std::numeric_limits<std::size_t>::max();
+    std::size_t highest = 0;
+};
+
+// Log-linear histogram of a metric of the finished processes, in the style of HdrHistogram, answering
+// quantile queries with a relative error below 1 / SUB_BUCKETS. Values below 2 * SUB_BUCKETS are kept exact.
+// NOTE: recording is O(1), memory is bounded by the magnitude of the largest value, not by the samples count
+struct [[nodiscard]] LatencyHistogram final
+{
+    constexpr static std::size_t SUB_BUCKETS       = 64;
+    constexpr static std::size_t SUB_BUCKET_BITS   = static_cast<std::size_t>(std::bit_width(SUB_BUCKETS - 1));
+    constexpr static std::size_t EXACT_UPPER_BOUND = 2 * SUB_BUCKETS;
+
+    void push(const std::size_t value)
+    {
+        const auto idx = bucket_of(value);
+        if (idx >= buckets.size()) { buckets.resize(idx + 1, 0); }
+
+        ++buckets[idx];
+        ++samples;
+        highest = std::max(highest, value);
+    }
+
+    // Smallest recorded value such that a `quantile` fraction of the samples is not greater than it,
+    // up to the precision of its bucket
+    [[nodiscard]] auto percentile(const double quantile) const -> std::size_t
+    {
+        if (samples == 0) { return 0; }
+
+        const auto rank = std::clamp(
+          static_cast<std::size_t>(std::ceil(quantile * static_cast<double>(samples))), std::size_t { 1 }, samples
+        );
+
+        std::size_t seen = 0;
+        for (std::size_t idx = 0; idx < buckets.size(); ++idx) {
+            seen += buckets[idx];
+            if (seen >= rank) { return std::min(highest_in_bucket(idx), highest); }
+        }
+
+        assert(false && "unreachable");
+        return highest;
+    }
+
+    void clear()
+    {
+        buckets.clear();
+        samples = 0;
+        highest = 0;
+    }
+
+    void serialize(this auto& self, auto& archive) { archive(self.buckets, self.samples, self.highest); }
+
+  private:
+    [[nodiscard]] constexpr static auto bucket_of(const std::size_t value) -> std::size_t
+    {
+        if (value < EXACT_UPPER_BOUND) { return value; }
+
+        // NOTE: keep the top SUB_BUCKET_BITS + 1 bits, whose leading one is implicit in the magnitude
+        const auto shift = static_cast<std::size_t>(std::bit_width(value)) - SUB_BUCKET_BITS - 1;
+        const auto top   = value >> shift;
+        return EXACT_UPPER_BOUND + (shift - 1) * SUB_BUCKETS + (top - SUB_BUCKETS);
+    }
+
+    [[nodiscard]] constexpr static auto highest_in_bucket(const std::size_t idx) -> std::size_t
+    {
+        if (idx < EXACT_UPPER_BOUND) { return idx; }
+
+        const auto shift = (idx - EXACT_UPPER_BOUND) / SUB_BUCKETS + 1;
+        const auto top   = (idx - EXACT_UPPER_BOUND) % SUB_BUCKETS + SUB_BUCKETS;
+        return ((top + 1) << shift) - 1;
+    }
+
+    std::vector<std::size_t> buckets;
+    std::size_t              samples = 0;
+    std::size_t              highest = 0;
+};
+
+} // namespace Simulations
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Simulations
+{
+
+// Set of the pids in use across all the cores of a simulation, as an open-addressing hash table with
+// linear probing. Erasing shifts the following entries back, so lookups never wade through tombstones.
+struct [[nodiscard]] PidRegistry final
+{
+    constexpr static std::size_t MIN_CAPACITY = 16;
+
+    // Returns false when `pid` was already in use
+    [[nodiscard]] auto insert(const std::size_t pid) -> bool
+    {
+        if (pid == EMPTY) { return !std::exchange(holds_empty_marker, true); }
+
+        if (2 * (count + 1) > slots.size()) { grow(); }
+
+        auto idx = home_of(pid);
+        while (slots[idx] != EMPTY) {
+            if (slots[idx] == pid) { return false; }
+            idx = (idx + 1) & mask();
+        }
+
+        slots[idx] = pid;
+        ++count;
+        return true;
+    }
+
+    [[nodiscard]] auto contains(const std::size_t pid) const -> bool
+    {
+        if (pid == EMPTY) { return holds_empty_marker; }
+        if (slots.empty()) { return false; }
+
+        for (auto idx = home_of(pid); slots[idx] != EMPTY; idx = (idx + 1) & mask()) {
+            if (slots[idx] == pid) { return true; }
+        }
+
+        return false;
+    }
+
+    void erase(const std::size_t pid)
+    {
+        if (pid == EMPTY) {
+            holds_empty_marker = false;
+            return;
+        }
+
+        if (slots.empty()) { return; }
+
+        auto hole = home_of(pid);
+        while (slots[hole] != pid) {
+            if (slots[hole] == EMPTY) { return; }
+            hole = (hole + 1) & mask();
+        }
+
+        // NOTE: an entry can fill the hole unless its home lies cyclically in (hole, idx]
+        for (auto idx = (hole + 1) & mask(); slots[idx] != EMPTY; idx = (idx + 1) & mask()) {
+            const auto home = home_of(slots[idx]);
+            if (((idx - home) & mask()) >= ((idx - hole) & mask())) {
+                slots[hole] = slots[idx];
+                hole        = idx;
+            }
+        }
+
+        slots[hole] = EMPTY;
+        --count;
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return count + (holds_empty_marker ? 1 : 0); }
+
+    void clear()
+    {
+        std::ranges::fill(slots, EMPTY);
+        count              = 0;
+        holds_empty_marker = false;
+    }
+
+    // Whether the table, as read back from a snapshot, has a size probing works with and keeps a free slot
+    [[nodiscard]] auto consistent() const -> bool
+    {
+        if (!slots.empty() && (slots.size() < MIN_CAPACITY || !std::has_single_bit(slots.size()))) { return false; }
+
+        const auto used = static_cast<std::size_t>(std::ranges::count_if(slots, [](const auto pid) {
+            return pid != EMPTY;
+        }));
+        return used == count && 2 * count <= slots.size();
+    }
+
+    void serialize(this auto& self, auto& archive) { archive(self.slots, self.count, self.holds_empty_marker); }
+
+  private:
+    // NOTE: the largest pid marks the free slots, whether it is in use is tracked on the side
+    constexpr static std::size_t EMPTY = std::numeric_limits<std::size_t>::max();
+
+    [[nodiscard]] auto mask() const -> std::size_t { return slots.size() - 1; }
+
+    // NOTE: Fibonacci hashing, spreads the consecutive pids scripts usually assign over the whole table
+    [[nodiscard]] auto home_of(const std::size_t pid) const -> std::size_t
+    {
+        constexpr std::uint64_t GOLDEN_RATIO = 0x9e37'79b9'7f4a'7c15ULL;
+        const auto              bits         = static_cast<std::size_t>(std::countr_zero(slots.size()));
+        return static_cast<std::size_t>((pid * GOLDEN_RATIO) >> (64 - bits));
+    }
+
+    void grow()
+    {
+        const auto capacity = std::max(MIN_CAPACITY, 2 * slots.size());
+        const auto previous = std::exchange(slots, std::vector<std::size_t>(capacity, EMPTY));
+        count               = 0;
+        for (const auto pid : previous) {
+            if (pid != EMPTY) { (void)insert(pid); }
+        }
+    }
+
+    std::vector<std::size_t> slots;
+    std::size_t              count              = 0;
+    bool                     holds_empty_marker = false;
+};
+
+} // namespace Simulations
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "os/Os.hpp"
+
+namespace Simulations
+{
+
+// Contiguous storage for all the processes of a simulation. Processes are referred to by
+// 32-bit handles which stay valid until the arena is cleared, even when the slab grows.
+// NOTE: the workloads in the slab never change once spawned, the state running them changes lives in the parallel
+// arrays below, one entry per handle, so that rewinding the processes to how they were spawned is a fill per array
+struct [[nodiscard]] ProcessArena final
+{
+    using Handle = std::uint32_t;
+
+    // Index of the current event among the events of the process
+    std::vector<std::uint32_t> cursors;
+
+    // Ticks the current event of the process still has to run for
+    std::vector<std::size_t> remainings;
+
+    std::vector<std::optional<std::size_t>> start_times;
+    std::vector<std::optional<std::size_t>> finish_times;
+    std::vector<std::optional<std::size_t>> first_run_times;
+
+    // NOTE: level of the process for the policies with priority levels, 0 being the highest
+    std::vector<std::size_t> priorities;
+    std::vector<std::size_t> vruntimes;
+
+    auto emplace(Os::Process process, const Os::EventPool& event_pool) -> Handle
+    {
+        assert(slab.size() < std::numeric_limits<Handle>::max() && "process arena is full");
+        const auto handle = static_cast<Handle>(slab.size());
+        remainings.push_back(first_duration(process, event_pool));
+        slab.push_back(std::move(process));
+
+        cursors.push_back(0);
+        start_times.emplace_back();
+        finish_times.emplace_back();
+        first_run_times.emplace_back();
+        priorities.push_back(0);
+        vruntimes.push_back(0);
+        return handle;
+    }
+
+    [[nodiscard]] auto operator[](const Handle handle) const -> const Os::Process&
+    {
+        assert(handle < slab.size() && "invalid process handle");
+        return slab[handle];
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return slab.size(); }
+
+    // Puts every process back to how it was spawned, keeping the handles valid
+    void rewind(const Os::EventPool& event_pool)
+    {
+        std::ranges::fill(cursors, 0);
+        std::ranges::transform(slab, remainings.begin(), [&](const Os::Process& process) {
+            return first_duration(process, event_pool);
+        });
+        std::ranges::fill(start_times, std::nullopt);
+        std::ranges::fill(finish_times, std::nullopt);
+        std::ranges::fill(first_run_times, std::nullopt);
+        std::ranges::fill(priorities, 0);
+        std::ranges::fill(vruntimes, 0);
+    }
+
+    // Whether the arena, as read back from a snapshot, holds the runtime state of every process, the events of each
+    // lying in `event_pool` and its weight being within 1 and `max_weight`
+    [[nodiscard]] auto consistent(const Os::EventPool& event_pool, const std::size_t max_weight) const -> bool
+    {
+        const auto processes = slab.size();
+        if (processes > std::numeric_limits<Handle>::max() || cursors.size() != processes
+            || remainings.size() != processes || start_times.size() != processes || finish_times.size() != processes
+            || first_run_times.size() != processes || priorities.size() != processes || vruntimes.size() != processes) {
+            return false;
+        }
+
+        for (std::size_t handle = 0; handle < processes; ++handle) {
+            const auto& process = slab[handle];
+            if (process.events.offset > event_pool.size()
+                || process.events.length > event_pool.size() - process.events.offset) {
+                return false;
+            }
+            if (process.weight == 0 || process.weight > max_weight || cursors[handle] > process.events.length) {
+                return false;
+            }
+
+            // NOTE: past its last event a process keeps what its last event had left, none after a CPU burst or the
+            // whole duration after an IO one, which is then bounded the same as while it runs
+            if (process.events.length == 0) {
+                if (remainings[handle] != 0) { return false; }
+                continue;
+            }
+            const auto current = process.events.offset + std::min(cursors[handle], process.events.length - 1);
+            if (remainings[handle] > event_pool.duration(current)) { return false; }
+        }
+
+        return true;
+    }
+
+    void clear()
+    {
+        slab.clear();
+        cursors.clear();
+        remainings.clear();
+        start_times.clear();
+        finish_times.clear();
+        first_run_times.clear();
+        priorities.clear();
+        vruntimes.clear();
+    }
+
+    void serialize(this auto& self, auto& archive)
+    {
+        archive(
+          self.slab,
+          self.cursors,
+          self.remainings,
+          self.start_times,
+          self.finish_times,
+          self.first_run_times,
+          self.priorities,
+          self.vruntimes
+        );
+    }
+
+  private:
+    [[nodiscard]] static auto first_duration(const Os::Process& process, const Os::EventPool& event_pool)
+      -> std::size_t
+    {
+        return process.events.length != 0 ? event_pool.duration(process.events.offset) : 0;
+    }
+
+    std::vector<Os::Process> slab;
+};
+
+} // namespace Simulations
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace Simulations
+{
+
+// Order in which a schedule policy wants the processes of a ready queue to be picked
+enum class ReadyOrder : std::uint8_t
+{
+    // NOTE: in insertion order, in O(1)
+    Fifo = 0,
+    // NOTE: smallest key first, in O(log n), with ties broken by insertion order
+    SmallestKey,
+    // NOTE: smallest key first, in O(1), keys being priority levels below `ReadyQueue::MAX_LEVELS`
+    Levels,
+    // NOTE: as `SmallestKey`, keys being virtual runtimes
+    VirtualRuntime,
+};
+
+// Ready queue of a core, every entry carrying a key which only matters to the policies picking by it.
+// In `ReadyOrder::SmallestKey` and `ReadyOrder::VirtualRuntime` the entries are kept as a binary min-heap on
+// (key, insertion order), so the smallest one always sits at the root.
+// In `ReadyOrder::Levels` every key has a FIFO queue of its own, and a bitmap of the non-empty ones
+// finds the first level to pick from with a single count of trailing zeros.
+template<typename T>
+struct [[nodiscard]] ReadyQueue final
+{
+    constexpr static std::size_t MAX_LEVELS = 64;
+
+    struct [[nodiscard]] Entry final
+    {
+        std::size_t key;
+        std::size_t sequence;
+        T           value;
+    };
+
+    void push(T value, const std::size_t key)
+    {
+        auto entry = Entry { .key = key, .sequence = next_sequence++, .value = std::move(value) };
+        ++count;
+
+        switch (order) {
+            case ReadyOrder::Fifo: {
+                queues.front().push_back(std::move(entry));
+                break;
+            }
+            case ReadyOrder::SmallestKey:
+            case ReadyOrder::VirtualRuntime: {
+                queues.front().push_back(std::move(entry));
+                std::ranges::push_heap(queues.front(), later);
+                break;
+            }
+            case ReadyOrder::Levels: {
+                assert(key < queues.size() && "priority level out of range");
+                queues[key].push_back(std::move(entry));
+                occupied |= std::uint64_t { 1 } << key;
+                break;
+            }
+        }
+    }
+
+    [[nodiscard]] auto front() const -> const Entry&
+    {
+        assert(count > 0 && "ready queue must not be empty");
+        return queues[first_level()].front();
+    }
+
+    [[nodiscard]] auto pop() -> T
+    {
+        assert(count > 0 && "ready queue must not be empty");
+        --count;
+
+        const auto level = first_level();
+        auto&      queue = queues[level];
+        if (heap_ordered()) {
+            std::ranges::pop_heap(queue, later);
+            auto value = std::move(queue.back().value);
+            queue.pop_back();
+            return value;
+        }
+
+        auto value = std::move(queue.front().value);
+        queue.pop_front();
+        if (order == ReadyOrder::Levels && queue.empty()) { occupied &= ~(std::uint64_t { 1 } << level); }
+
+        return value;
+    }
+
+    // Takes the entry which would be picked last, in O(1), leaving the front for the core which owns the queue.
+    // NOTE: of a heap it takes the last leaf, which is among the entries picked last without being the last one
+    [[nodiscard]] auto steal() -> T
+    {
+        assert(count > 0 && "ready queue must not be empty");
+        --count;
+
+        const auto level = last_level();
+        auto&      queue = queues[level];
+        auto       value = std::move(queue.back().value);
+        queue.pop_back();
+        if (order == ReadyOrder::Levels && queue.empty()) { occupied &= ~(std::uint64_t { 1 } << level); }
+
+        return value;
+    }
+
+    // Requeues every entry, in insertion order, under `new_order` with `levels` priority levels and the key
+    // `key_of(value)`. Runs in O(n log n) at worst, so it is meant for when the schedule policy changes.
+    void rebuild(const ReadyOrder new_order, const std::size_t levels, const auto& key_of)
+    {
+        assert(levels > 0 && levels <= MAX_LEVELS && "unsupported number of priority levels");
+
+        std::vector<Entry> entries;
+        entries.reserve(count);
+        for (auto& queue : queues) { std::ranges::move(queue, std::back_inserter(entries)); }
+        std::ranges::sort(entries, std::less {}, &Entry::sequence);
+
+        order = new_order;
+        queues.assign(order == ReadyOrder::Levels ? levels : 1, {});
+        occupied      = 0;
+        count         = 0;
+        next_sequence = 0;
+        for (auto& entry : entries) {
+            const auto key = key_of(entry.value);
+            push(std::move(entry.value), key);
+        }
+    }
+
+    [[nodiscard]] auto ordering() const -> ReadyOrder { return order; }
+
+    // NOTE: iteration is in picking order only with `ReadyOrder::Fifo`
+    [[nodiscard]] auto values() const
+    {
+        return queues | std::views::join | std::views::transform(&Entry::value);
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return count; }
+    [[nodiscard]] auto empty() const -> bool { return count == 0; }
+
+    void clear()
+    {
+        for (auto& queue : queues) { queue.clear(); }
+        occupied = 0;
+        count    = 0;
+    }
+
+    // Whether the queue, as read back from a snapshot, is kept in `expected` order with `levels` priority levels and
+    // keeps the invariants picking from it relies on, every value being accepted by `valid_value`
+    [[nodiscard]] auto consistent(const ReadyOrder expected, const std::size_t levels, const auto& valid_value) const
+      -> bool
+    {
+        if (order != expected || queues.size() != (order == ReadyOrder::Levels ? levels : 1)) { return false; }
+        if (queues.size() > MAX_LEVELS) { return false; }
+
+        std::size_t entries = 0;
+        for (std::size_t level = 0; level < queues.size(); ++level) {
+            const auto& queue = queues[level];
+            entries += queue.size();
+
+            const auto marked = ((occupied >> level) & 1U) != 0;
+            if (order == ReadyOrder::Levels && marked == queue.empty()) { return false; }
+            if (heap_ordered() && !std::ranges::is_heap(queue, later)) { return false; }
+
+            const auto valid_entry = [&](const Entry& entry) {
+                return entry.sequence < next_sequence && valid_value(entry.value)
+                       && (order != ReadyOrder::Levels || entry.key == level);
+            };
+            if (!std::ranges::all_of(queue, valid_entry)) { return false; }
+        }
+
+        const auto stray_levels = order == ReadyOrder::Levels ? occupied >> (queues.size() - 1) >> 1U : occupied;
+        return entries == count && stray_levels == 0;
+    }
+
+    void serialize(this auto& self, auto& archive)
+    {
+        archive(self.queues, self.occupied, self.count, self.next_sequence, self.order);
+    }
+
+  private:
+    constexpr static auto later = [](const Entry& lhs, const Entry& rhs) {
+        return std::pair { lhs.key, lhs.sequence } > std::pair { rhs.key, rhs.sequence };
+    };
+
+    [[nodiscard]] auto heap_ordered() const -> bool
+    {
+        return order == ReadyOrder::SmallestKey || order == ReadyOrder::VirtualRuntime;
+    }
+
+    [[nodiscard]] auto first_level() const -> std::size_t
+    {
+        if (order != ReadyOrder::Levels) { return 0; }
+
+        assert(occupied != 0 && "ready queue must not be empty");
+        return static_cast<std::size_t>(std::countr_zero(occupied));
+    }
+
+    [[nodiscard]] auto last_level() const -> std::size_t
+    {
+        if (order != ReadyOrder::Levels) { return 0; }
+
+        assert(occupied != 0 && "ready queue must not be empty");
+        return static_cast<std::size_t>(std::bit_width(occupied)) - 1;
+    }
+
+    std::vector<std::deque<Entry>> queues = std::vector<std::deque<Entry>>(1);
+
+    std::uint64_t occupied      = 0;
+    std::size_t   count         = 0;
+    std::size_t   next_sequence = 0;
+    ReadyOrder    order         = ReadyOrder::Fifo;
+};
+
+} // namespace Simulations
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace Simulations
+{
+
+// Highest values reached by the averages of a simulation while it runs
+struct [[nodiscard]] MetricPeaks final
+{
+    std::size_t waiting_time    = 0;
+    std::size_t turnaround_time = 0;
+    double      throughput      = 0;
+
+    void sample(const auto& sim)
+    {
+        waiting_time    = std::max(waiting_time, sim.average_waiting_time());
+        turnaround_time = std::max(turnaround_time, sim.average_turnaround_time());
+        throughput      = std::max(throughput, sim.throughput);
+    }
+};
+
+// Tail latencies reported for each metric kept in a `LatencyHistogram`, labelled as in the results
+constexpr auto REPORTED_PERCENTILES = std::array {
+    std::pair<std::string_view, double> { "p50", 0.50 },
+    std::pair<std::string_view, double> { "p90", 0.90 },
+    std::pair<std::string_view, double> { "p99", 0.99 },
+    std::pair<std::string_view, double> { "p999", 0.999 },
+};
+
+// Results of a simulation in the `key = value` format read back by the comparator
+[[nodiscard]] auto format_report(const auto& sim, const MetricPeaks& peaks) -> std::string
+{
+    std::string report;
+    auto        out = std::back_inserter(report);
+
+    std::format_to(out, "timer = {}\n", sim.timer);
+    std::format_to(out, "schedule_policy = {}\n", sim.schedule_policy.name());
+
+    std::format_to(out, "separator\n");
+
+    std::format_to(out, "avg_waiting_time = {}\n", sim.average_waiting_time());
+    std::format_to(out, "max_waiting_time = {}\n", peaks.waiting_time);
+    std::format_to(out, "avg_turnaround_time = {}\n", sim.average_turnaround_time());
+    std::format_to(out, "max_turnaround_time = {}\n", peaks.turnaround_time);
+    std::format_to(out, "shortest_waiting_time = {}\n", sim.waiting_times.min());
+    std::format_to(out, "longest_waiting_time = {}\n", sim.waiting_times.max());
+    std::format_to(out, "shortest_turnaround_time = {}\n", sim.turnaround_times.min());
+    std::format_to(out, "longest_turnaround_time = {}\n", sim.turnaround_times.max());
+    std::format_to(out, "avg_throughput = {:.2f}\n", sim.throughput);
+    std::format_to(out, "max_throughput = {:.2f}\n", peaks.throughput);
+    std::format_to(out, "migrations = {}\n", sim.migrations);
+
+    std::format_to(out, "separator\n");
+
+    const auto format_percentiles = [&](const std::string_view metric, const auto& histogram) {
+        for (const auto& [label, quantile] : REPORTED_PERCENTILES) {
+            std::format_to(out, "{}_{} = {}\n", label, metric, histogram.percentile(quantile));
+        }
+    };
+
+    format_percentiles("waiting_time", sim.waiting_time_histogram);
+    format_percentiles("turnaround_time", sim.turnaround_time_histogram);
+    format_percentiles("response_time", sim.response_time_histogram);
+
+    return report;
+}
+
+} // namespace Simulations
@@ -1,25 +1,59 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <format>
 #include <functional>
 #include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
 #include <utility>
 #include <cassert>
 
+#include "ArrivalCalendar.hpp"
+#include "CompletionQueue.hpp"
+#include "Metrics.hpp"
+#include "PidRegistry.hpp"
+#include "ProcessArena.hpp"
+#include "ReadyQueue.hpp"
+#include "Trace.hpp"
+#include "WorkerPool.hpp"
 #include "os/Os.hpp"
+#include "Random.hpp"
 
 namespace Simulations
 {
 
-struct Scheduler;
+template<typename Policy>
+struct BasicScheduler;
 
-using ScheduleFn = std::function<void(Scheduler&)>;
+struct NamedSchedulePolicy;
+
+// NOTE: the policy can be switched at runtime, at the cost of calling it through a `std::function`
+using Scheduler = BasicScheduler<NamedSchedulePolicy>;
+
+// NOTE: a policy only schedules on the core it is called for, which lets cores be stepped concurrently
+using ScheduleFn = std::function<void(Scheduler&, std::size_t)>;
 
 enum class SchedulePolicy : std::uint8_t
 {
     FirstComeFirstServed = 0,
     RoundRobin,
+    ShortestJobFirst,
+    ShortestRemainingTimeFirst,
+    MultiLevelFeedbackQueue,
+    CompletelyFair,
+    Count,
+};
+
+// Where the cores of a simulation take the processes to run from
+enum class RunQueueMode : std::uint8_t
+{
+    // NOTE: every core has a ready queue of its own, and processes never leave the core they were spawned on
+    PerCore = 0,
+    // NOTE: all the cores pick from a single shared ready queue, so a process runs on whichever core is free
+    Global,
     Count,
 };
 
@@ -40,6 +74,18 @@ struct std::formatter<Simulations::SchedulePolicy>
                 case Simulations::SchedulePolicy::RoundRobin: {
                     return "Round Robin";
                 }
+                case Simulations::SchedulePolicy::ShortestJobFirst: {
+                    return "Shortest Job First";
+                }
+                case Simulations::SchedulePolicy::ShortestRemainingTimeFirst: {
+                    return "Shortest Remaining Time First";
+                }
+                case Simulations::SchedulePolicy::MultiLevelFeedbackQueue: {
+                    return "Multi Level Feedback Queue";
+                }
+                case Simulations::SchedulePolicy::CompletelyFair: {
+                    return "Completely Fair";
+                }
                 default: {
                     assert(false && "unreachable");
                     return "";
@@ -56,70 +102,305 @@ namespace Simulations
 
 struct [[nodiscard]] NamedSchedulePolicy final
 {
-    NamedSchedulePolicy(std::string name, SchedulePolicy kind, ScheduleFn callback)
-      : callback_ { std::move(callback) },
+    template<typename Policy>
+    NamedSchedulePolicy(std::string name, SchedulePolicy kind, Policy policy)
+      : callback_ { std::move(policy) },
         kind_ { kind },
+        ready_order_ { Policy::ready_order() },
         name_ { std::move(name) }
     {}
 
-    void operator()(Scheduler& sim) { callback_(sim); };
+    void operator()(Scheduler& sim, const std::size_t thread_idx) const { callback_(sim, thread_idx); };
 
     [[nodiscard]] auto name() const -> std::string { return name_; }
     [[nodiscard]] auto kind() const -> SchedulePolicy { return kind_; }
+    [[nodiscard]] auto ready_order() const -> ReadyOrder { return ready_order_; }
 
   private:
     ScheduleFn     callback_;
     SchedulePolicy kind_;
+    ReadyOrder     ready_order_;
     std::string    name_;
 };
 
 
-struct [[nodiscard]] Scheduler final
+// Number of processes in each state of their lifecycle
+struct [[nodiscard]] Population final
 {
-    constexpr static auto MAX_THREADS = 9;
+    std::size_t arriving = 0;
+    std::size_t ready    = 0;
+    std::size_t running  = 0;
+    std::size_t waiting  = 0;
+    std::size_t finished = 0;
+
+    // Processes the simulation still has to finish
+    [[nodiscard]] auto live() const -> std::size_t { return arriving + ready + running + waiting; }
+
+    auto operator+=(const Population& other) -> Population&
+    {
+        arriving += other.arriving;
+        ready += other.ready;
+        running += other.running;
+        waiting += other.waiting;
+        finished += other.finished;
+        return *this;
+    }
+
+    [[nodiscard]] auto operator==(const Population& other) const -> bool = default;
+};
+
+
+// Simulation of a multicore CPU scheduling processes with `Policy`, which is called as `policy(sim, thread_idx)`
+// on every tick of the core `thread_idx`, busy or not, so that it can also preempt. `policy.ready_order()` tells
+// how the ready queues are to be kept. Knowing the policy at compile time lets it be inlined into `step()`.
+template<typename Policy>
+struct [[nodiscard]] BasicScheduler final
+{
+    constexpr static std::size_t DEFAULT_THREADS = 9;
+    constexpr static std::size_t DEFAULT_QUANTUM = 5;
+
+    constexpr static std::size_t DEFAULT_PRIORITY_LEVELS       = 3;
+    constexpr static std::size_t DEFAULT_PRIORITY_BOOST_PERIOD = 100;
+    constexpr static std::size_t MAX_PRIORITY_LEVELS           = ReadyQueue<ProcessArena::Handle>::MAX_LEVELS;
 
-    using ProcessPtr   = std::shared_ptr<Os::Process>;
-    using ProcessQueue = std::deque<ProcessPtr>;
+    // NOTE: virtual runtime a process of `Os::DEFAULT_WEIGHT` accrues in a tick is `VIRTUAL_TICK / Os::DEFAULT_WEIGHT`,
+    // scaled up so that every weight up to `MAX_WEIGHT` still accrues some of it in a single tick
+    constexpr static std::size_t VIRTUAL_TICK = std::size_t { 1 } << 20U;
+    constexpr static std::size_t MAX_WEIGHT   = VIRTUAL_TICK;
 
-    std::array<ProcessPtr, MAX_THREADS>   running;
-    std::array<ProcessQueue, MAX_THREADS> processes;
-    std::array<ProcessQueue, MAX_THREADS> waiting;
-    std::array<ProcessQueue, MAX_THREADS> ready;
+    // NOTE: time slice of the processes run by policies that never preempt
+    constexpr static std::size_t UNLIMITED_SLICE = std::numeric_limits<std::size_t>::max();
 
-    NamedSchedulePolicy            schedule_policy;
-    std::size_t                    timer     = 0;
-    std::array<float, MAX_THREADS> cpu_usage = {};
+    // NOTE: fixed instead of std::hardware_destructive_interference_size, whose value is not ABI stable
+    constexpr static std::size_t CACHE_LINE_SIZE = 64;
+
+    using ProcessHandle   = ProcessArena::Handle;
+    using ProcessQueue    = ReadyQueue<ProcessHandle>;
+    using ProcessCalendar = ArrivalCalendar<ProcessHandle>;
+    using IoQueue         = CompletionQueue<ProcessHandle>;
+
+    // State owned by a single simulated core, aligned so that neighbouring cores never share a cache line
+    struct alignas(CACHE_LINE_SIZE) Core final
+    {
+        std::optional<ProcessHandle> running;
+        std::size_t                  slice_left = UNLIMITED_SLICE;
+        ProcessCalendar              arrivals;
+        IoQueue                      waiting;
+        ProcessQueue                 ready;
+        float                        cpu_usage = 0.0F;
+
+        // NOTE: processes this core took from the ready queues of the others
+        std::size_t steals = 0;
+
+        // NOTE: never decreasing lower bound of the virtual runtimes on the core, where the processes becoming
+        // ready are placed so that a long sleep does not buy them the core for as long
+        std::size_t min_vruntime = 0;
+
+        // NOTE: processes completed during the current tick, merged into `finished` at its end
+        std::vector<ProcessHandle> finished;
+
+        // NOTE: processes which became ready on the core with a global run queue, published into it in core order
+        std::vector<ProcessHandle> readied;
+
+        // NOTE: transitions traced on the core during the current tick, only written to by the thread stepping it
+        // and appended to the trace in core order at the end of the tick
+        std::vector<TraceRecord> traced;
+
+        // NOTE: counted at the end of every step of the core, so policies are free to move processes around
+        Population population;
+
+        void serialize(this auto& self, auto& archive)
+        {
+            archive(
+              self.running,
+              self.slice_left,
+              self.arrivals,
+              self.waiting,
+              self.ready,
+              self.cpu_usage,
+              self.min_vruntime,
+              self.steals,
+              self.finished,
+              self.readied,
+              self.population
+            );
+        }
+    };
+
+    ProcessArena      arena;
+    Os::EventPool     event_pool;
+    std::vector<Core> cores = std::vector<Core>(DEFAULT_THREADS);
+
+    Policy      schedule_policy;
+    std::size_t timer = 0;
 
     std::size_t max_processes             = std::numeric_limits<std::size_t>::max();
     std::size_t max_events_per_process    = std::numeric_limits<std::size_t>::max();
     std::size_t max_single_event_duration = std::numeric_limits<std::size_t>::max();
     std::size_t max_arrival_time          = std::numeric_limits<std::size_t>::max();
-    std::size_t threads_count             = MAX_THREADS;
+
+    // NOTE: ticks a process may run before being preempted, for the policies that preempt
+    std::size_t quantum = DEFAULT_QUANTUM;
+
+    // NOTE: for the policies with priority levels, where a process which used up its time slice moves one level
+    // down and every process moves back to the top level once every `priority_boost_period` ticks (never if 0)
+    std::size_t priority_levels       = DEFAULT_PRIORITY_LEVELS;
+    std::size_t priority_boost_period = DEFAULT_PRIORITY_BOOST_PERIOD;
+
+    // NOTE: the source of every random draw of the simulation, which can be reseeded to reproduce a workload
+    Util::Random rng;
 
     std::size_t next_thread = 0;
 
-    double                  throughput              = 0;
-    std::size_t             previous_finished_count = 0;
-    std::vector<ProcessPtr> finished;
+    RunQueueMode run_queue_mode = RunQueueMode::PerCore;
 
-    std::array<std::deque<Os::Process>, MAX_THREADS> processes_backup;
-    bool                                             valid_backup = false;
+    // NOTE: with per-core run queues, a core with nothing to run steals from the core with the most ready processes
+    // once it holds at least `steal_threshold` of them (never if 0)
+    std::size_t steal_threshold = 0;
+    std::size_t migrations      = 0;
 
-    template<std::invocable<Scheduler&> Policy>
-    explicit Scheduler(Policy policy)
-      : schedule_policy { policy }
-    {}
+    // NOTE: the ready queue of all the cores with `RunQueueMode::Global`, the per-core ones staying empty
+    ProcessQueue shared_ready;
+    std::size_t  shared_min_vruntime = 0;
+
+    // NOTE: summed over the cores at the end of every tick
+    Population population;
+
+    // NOTE: pids of the processes admitted and not finished yet, on any core
+    PidRegistry pids;
+
+    double                     throughput              = 0;
+    std::size_t                previous_finished_count = 0;
+    std::vector<ProcessHandle> finished;
+
+    // NOTE: only the finished processes which got a start (finish) time contribute, the averages still divide by
+    // the size of `finished`
+    RunningTotal waiting_times;
+    RunningTotal turnaround_times;
+
+    // NOTE: fed the same samples as the running totals, the response time being the wait for the first CPU burst
+    LatencyHistogram waiting_time_histogram;
+    LatencyHistogram turnaround_time_histogram;
+    LatencyHistogram response_time_histogram;
+
+    std::unique_ptr<WorkerPool> workers;
+
+    // NOTE: every state transition of the processes is recorded into it while set, see `Trace.hpp`, which is only
+    // possible with up to `TRACE_MAX_CORES` cores
+    std::unique_ptr<TraceFile> trace;
+
+    explicit BasicScheduler(Policy policy)
+      : schedule_policy { std::move(policy) }
+    {
+        order_ready_queues();
+    }
+
+    ~BasicScheduler() = default;
+
+    BasicScheduler(const BasicScheduler&)            = delete;
+    BasicScheduler& operator=(const BasicScheduler&) = delete;
+
+    BasicScheduler(BasicScheduler&&) noexcept            = default;
+    BasicScheduler& operator=(BasicScheduler&&) noexcept = default;
+
+    void switch_schedule_policy(Policy policy)
+    {
+        schedule_policy = std::move(policy);
+        order_ready_queues();
+    }
+
+    [[nodiscard]] auto threads_count() const -> std::size_t { return cores.size(); }
+
+    // NOTE: the processes spawned so far stay on the cores they were spawned on, which therefore cannot be dropped
+    void set_threads_count(const std::size_t count)
+    {
+        assert(count > 0 && "a simulation needs at least one core");
+        assert((arena.size() == 0 || count >= threads_count()) && "cores holding processes cannot be dropped");
+        assert((!trace || count <= TRACE_MAX_CORES) && "too many cores to be traced");
+        cores.resize(count);
+        next_thread %= count;
+        order_ready_queues();
+        population = total_population();
+    }
+
+    void set_priority_levels(const std::size_t count)
+    {
+        assert(count > 0 && count <= MAX_PRIORITY_LEVELS && "unsupported number of priority levels");
+        priority_levels = count;
+        order_ready_queues();
+    }
+
+    // Moves every ready process into the ready queues of `mode`, spreading them over the cores in picking order
+    // when going back to per-core queues
+    void set_run_queue_mode(const RunQueueMode mode)
+    {
+        if (mode == run_queue_mode) { return; }
+
+        std::vector<ProcessHandle> readied;
+        for (auto& core : cores) {
+            while (!core.ready.empty()) { readied.push_back(core.ready.pop()); }
+        }
+        while (!shared_ready.empty()) { readied.push_back(shared_ready.pop()); }
+
+        run_queue_mode = mode;
+        for (std::size_t idx = 0; idx < readied.size(); ++idx) { make_ready(idx % threads_count(), readied[idx]); }
+
+        for (auto& core : cores) { count_population(core); }
+        population = total_population();
+    }
+
+    [[nodiscard]] auto global_run_queue() const -> bool { return run_queue_mode == RunQueueMode::Global; }
+
+    // Ready queue the core `thread_idx` picks its processes from
+    [[nodiscard]] auto ready_queue(const std::size_t thread_idx) -> ProcessQueue&
+    {
+        return global_run_queue() ? shared_ready : cores[thread_idx].ready;
+    }
+
+    [[nodiscard]] auto ready_queue(const std::size_t thread_idx) const -> const ProcessQueue&
+    {
+        return global_run_queue() ? shared_ready : cores[thread_idx].ready;
+    }
+
+    // Lower bound of the virtual runtimes of the processes the core `thread_idx` picks from
+    [[nodiscard]] auto min_vruntime(const std::size_t thread_idx) -> std::size_t&
+    {
+        return global_run_queue() ? shared_min_vruntime : cores[thread_idx].min_vruntime;
+    }
+
+    // Priority level `handle` is queued, sliced and ranked on.
+    // NOTE: a process demoted while there were more levels than now counts as being on the last one
+    [[nodiscard]] auto priority_level(const ProcessHandle handle) const -> std::size_t
+    {
+        return std::min(arena.priorities[handle], priority_levels - 1);
+    }
+
+    // Time slice of the processes on priority level `level`, which doubles at every level down.
+    // NOTE: saturates at `UNLIMITED_SLICE` once the doubling overflows, the deepest levels then run to completion
+    [[nodiscard]] auto level_quantum(const std::size_t level) const -> std::size_t
+    {
+        if (level >= static_cast<std::size_t>(std::numeric_limits<std::size_t>::digits)
+            || quantum > (UNLIMITED_SLICE >> level)) {
+            return UNLIMITED_SLICE;
+        }
 
-    ~Scheduler() = default;
+        return quantum << level;
+    }
 
-    Scheduler(const Scheduler&)            = delete;
-    Scheduler& operator=(const Scheduler&) = delete;
+    [[nodiscard]] auto host_threads() const -> std::size_t { return workers ? workers->host_threads() : 1; }
 
-    Scheduler(Scheduler&&) noexcept            = default;
-    Scheduler& operator=(Scheduler&&) noexcept = default;
+    // Steps the cores of every tick concurrently on `count` host threads, the calling thread included.
+    // The outcome is the same as stepping them one after the other on a single thread.
+    void set_host_threads(const std::size_t count)
+    {
+        assert(count > 0 && "a simulation needs at least one host thread");
+        if (count == host_threads()) { return; }
 
-    void switch_schedule_policy(std::invocable<Scheduler&> auto policy) { schedule_policy = std::move(policy); }
+        workers = count > 1 ? std::make_unique<WorkerPool>(count) : nullptr;
+    }
 
+    // Replays the workload from tick 0.
+    // NOTE: the processes are rewound in place rather than spawned again, nothing is allocated
     void restart()
     {
         timer                   = 0;
@@ -128,148 +409,636 @@ struct [[nodiscard]] Scheduler final
         previous_finished_count = 0;
         finished.clear();
         finished.shrink_to_fit();
-
-        assert(valid_backup && "unreachable");
-        for (const auto& [idx, queue] : std::views::zip(std::views::iota(0UL), processes_backup)) {
-            for (const auto& process : queue) { processes[idx].push_back(std::make_shared<Os::Process>(process)); }
+        waiting_times.clear();
+        turnaround_times.clear();
+        pids.clear();
+        waiting_time_histogram.clear();
+        turnaround_time_histogram.clear();
+        response_time_histogram.clear();
+        arena.rewind(event_pool);
+        migrations = 0;
+        shared_ready.clear();
+        shared_min_vruntime = 0;
+
+        for (auto& core : cores) {
+            core.running      = std::nullopt;
+            core.slice_left   = UNLIMITED_SLICE;
+            core.min_vruntime = 0;
+            core.arrivals.rewind();
+            core.waiting.clear();
+            core.ready.clear();
+            core.finished.clear();
+            core.readied.clear();
+            core.traced.clear();
+            core.steals    = 0;
+            core.cpu_usage = 0.0F;
+
+            count_population(core);
         }
+
+        population = total_population();
+    }
+
+    [[nodiscard]] auto complete() const -> bool { return population.live() == 0; }
+
+    // Visits the whole state of the simulation with `archive(fields...)`, but for the policy, the host threads and the
+    // trace, which are not part of the simulated machine. See `Snapshot.hpp`.
+    void serialize(this auto& self, auto& archive)
+    {
+        archive(
+          self.arena,
+          self.event_pool,
+          self.cores,
+          self.timer,
+          self.max_processes,
+          self.max_events_per_process,
+          self.max_single_event_duration,
+          self.max_arrival_time,
+          self.quantum,
+          self.priority_levels,
+          self.priority_boost_period,
+          self.rng,
+          self.next_thread,
+          self.run_queue_mode,
+          self.shared_ready,
+          self.shared_min_vruntime,
+          self.steal_threshold,
+          self.migrations,
+          self.population,
+          self.pids,
+          self.throughput,
+          self.previous_finished_count,
+          self.finished,
+          self.waiting_times,
+          self.turnaround_times,
+          self.waiting_time_histogram,
+          self.turnaround_time_histogram,
+          self.response_time_histogram
+        );
     }
 
-    [[nodiscard]] auto complete() const -> bool
+    // Whether the state, as read back from a snapshot, keeps the invariants stepping relies on: every handle refers
+    // to a spawned process, every process to events of the pool, the queues are ordered for the policy and the
+    // populations match what they count.
+    // NOTE: O(n) in the processes of the simulation
+    [[nodiscard]] auto consistent() const -> bool
     {
-        const auto any_running   = std::ranges::any_of(running, [](const auto& process) { return process != nullptr; });
-        const auto any_processes = std::ranges::any_of(processes, [](const auto& elem) { return !elem.empty(); });
-        const auto any_ready     = std::ranges::any_of(ready, [](const auto& elem) { return !elem.empty(); });
-        const auto any_waiting   = std::ranges::any_of(waiting, [](const auto& elem) { return !elem.empty(); });
+        if (cores.empty() || next_thread >= threads_count() || quantum == 0) { return false; }
+        if (priority_levels == 0 || priority_levels > MAX_PRIORITY_LEVELS) { return false; }
+        if (!event_pool.consistent() || !arena.consistent(event_pool, MAX_WEIGHT) || !pids.consistent()) {
+            return false;
+        }
+
+        const auto valid_handle = [this](const ProcessHandle handle) { return handle < arena.size(); };
+        const auto on_event     = [&](const Os::EventKind kind) {
+            return [this, valid_handle, kind](const ProcessHandle handle) {
+                return valid_handle(handle) && has_events(handle) && event_pool.kind(current_event(handle)) == kind;
+            };
+        };
+        const auto on_cpu  = on_event(Os::EventKind::Cpu);
+        const auto on_io   = on_event(Os::EventKind::Io);
+        const auto is_done = [&](const ProcessHandle handle) { return valid_handle(handle) && !has_events(handle); };
+
+        const auto order = schedule_policy.ready_order();
+        if (!shared_ready.consistent(order, priority_levels, on_cpu)) { return false; }
+        if (!std::ranges::all_of(finished, is_done)) { return false; }
+
+        for (const auto& core : cores) {
+            if (!core.arrivals.consistent(timer, valid_handle) || !core.waiting.consistent(on_io)
+                || !core.ready.consistent(order, priority_levels, on_cpu)) {
+                return false;
+            }
+            if (!std::ranges::all_of(core.finished, is_done) || !std::ranges::all_of(core.readied, on_cpu)) {
+                return false;
+            }
+            if (!core.waiting.empty() && core.waiting.next_completion() < timer) { return false; }
+            if (core.population != counted_population(core)) { return false; }
+
+            if (core.running
+                && (!on_cpu(*core.running) || arena.remainings[*core.running] == 0 || core.slice_left == 0)) {
+                return false;
+            }
+        }
 
-        return !any_running && !any_processes && !any_ready && !any_waiting;
+        // NOTE: a process is in a single place at a time, among the processes still to arrive, ready, running,
+        // waiting and finished
+        std::vector<bool> placed(arena.size(), false);
+        const auto        place_once = [&](const ProcessHandle handle) {
+            if (placed[handle]) { return false; }
+            placed[handle] = true;
+            return true;
+        };
+        const auto place_all = [&](auto&& handles) { return std::ranges::all_of(handles, place_once); };
+
+        if (!place_all(shared_ready.values()) || !place_all(finished)) { return false; }
+        for (const auto& core : cores) {
+            if (!place_all(core.arrivals.values()) || !place_all(core.ready.values())
+                || !place_all(core.waiting | std::views::transform(&IoQueue::Entry::value)) || !place_all(core.finished)
+                || !place_all(core.readied) || (core.running && !place_once(*core.running))) {
+                return false;
+            }
+        }
+
+        return population == total_population();
     }
 
     void step()
     {
-        valid_backup = true;
+        if (priority_boost_due()) { boost_priorities(); }
 
-        for (std::size_t thread_idx = 0; thread_idx < threads_count; ++thread_idx) {
+        // NOTE: serial, so that every core checks the same pid registry and admits in a fixed order
+        for (std::size_t thread_idx = 0; thread_idx < threads_count(); ++thread_idx) {
             sidetrack_processes(thread_idx);
-            update_waiting_list(thread_idx);
-            update_running(thread_idx);
+        }
 
-            if (!running[thread_idx]) { schedule_policy(*this); }
-            if (!running[thread_idx] && ready[thread_idx].size() > 0) {
-                running[thread_idx] = ready[thread_idx].front();
-                ready[thread_idx].pop_front();
+        if (steal_due()) { balance_load(); }
+
+        if (global_run_queue()) {
+            publish_readied();
+            for_each_core([this](const std::size_t thread_idx) { advance_core(thread_idx); });
+            publish_readied();
+
+            // NOTE: serial, the cores pick from the shared queue one after the other in core order, so that which
+            // core runs what does not depend on how the cores were stepped
+            for (std::size_t thread_idx = 0; thread_idx < threads_count(); ++thread_idx) {
+                schedule_core(thread_idx);
+                publish_readied(thread_idx);
             }
+        } else {
+            for_each_core([this](const std::size_t thread_idx) {
+                advance_core(thread_idx);
+                schedule_core(thread_idx);
+            });
+        }
+
+        end_tick();
+    }
+
+    // Jumps `timer` over the ticks in which nothing can change and then performs the tick in which
+    // the next arrival, IO completion, CPU completion or dispatch happens. The resulting state is
+    // the same as the one reached by calling `step()` until that tick is done.
+    void step_to_next_event()
+    {
+        skip_idle_ticks();
+        step();
+    }
+
+    void run_to_completion()
+    {
+        while (!complete()) { step_to_next_event(); }
+    }
+
+    // Number of upcoming ticks in which `step()` would only decrement the duration of the current events.
+    [[nodiscard]] auto idle_ticks() const -> std::size_t
+    {
+        if (complete()) { return 0; }
+
+        // NOTE: a free core with something ready dispatches, a busy one only preempts for a process which became
+        // ready, and nothing becomes ready without an arrival or an IO completion
+        const auto dispatches = [this](const std::size_t thread_idx) {
+            return !cores[thread_idx].running && !ready_queue(thread_idx).empty();
+        };
+        if (std::ranges::any_of(std::views::iota(std::size_t { 0 }, threads_count()), dispatches)) { return 0; }
+        if (steal_due()) { return 0; }
+
+        // NOTE: an event with `duration` ticks left completes during the `duration`-th tick from now,
+        // unless the time slice of the process runs out first
+        const auto ticks_before_completion = [this](const Core& core) -> std::size_t {
+            const auto remaining = arena.remainings[*core.running];
+            assert(has_events(*core.running) && "event queue must not be empty");
+            assert(remaining > 0 && core.slice_left > 0);
+            return std::min(remaining, core.slice_left) - 1;
+        };
 
-            if (running[thread_idx] && !running[thread_idx]->events.empty()) {
-                const auto& next_event = running[thread_idx]->events.front();
-                cpu_usage[thread_idx]  = next_event.resource_usage;
+        auto idle = std::numeric_limits<std::size_t>::max();
+        for (const auto& core : cores) {
+            if (const auto arrival = core.arrivals.next_tick(timer); arrival.has_value()) {
+                idle = std::min(idle, *arrival - timer);
             }
 
-            if (complete()) { cpu_usage.fill(0.0F); };
+            if (!core.waiting.empty()) { idle = std::min(idle, core.waiting.next_completion() - timer); }
 
-            throughput = timer != 0 ? static_cast<double>(finished.size()) / static_cast<double>(timer) : 0.0;
-            previous_finished_count = finished.size();
+            if (core.running) { idle = std::min(idle, ticks_before_completion(core)); }
         }
 
-        ++timer;
+        // NOTE: boosting reorders the ready queues, which may lead to a preemption
+        if (uses_priority_levels() && priority_boost_period != 0) {
+            idle = std::min(idle, (priority_boost_period - timer % priority_boost_period) % priority_boost_period);
+        }
+
+        // NOTE: nothing bounds the jump, fall back to plain stepping
+        if (idle == std::numeric_limits<std::size_t>::max()) { return 0; }
+
+        return idle;
     }
 
-    template<typename... Args>
-    constexpr auto emplace_process(Args&&... args) -> ProcessPtr
+    auto emplace_process(
+      std::string                      name,
+      const std::size_t                pid,
+      const std::size_t                arrival,
+      const std::span<const Os::Event> events,
+      const std::size_t                weight = Os::DEFAULT_WEIGHT
+    ) -> ProcessHandle
     {
-        const auto ret =
-          processes[next_thread].emplace_back(std::make_shared<Os::Process>(std::forward<Args>(args)...));
-        if (!valid_backup) { processes_backup[next_thread].push_back(*ret); }
-        next_thread = (next_thread + 1) % threads_count;
-        return ret;
+        assert(weight > 0 && weight <= MAX_WEIGHT && "unsupported process weight");
+
+        auto spawned = Os::Process {
+            .name    = std::move(name),
+            .pid     = pid,
+            .arrival = arrival,
+            .events  = event_pool.append(events),
+            .weight  = weight,
+        };
+        const auto handle = arena.emplace(std::move(spawned), event_pool);
+        auto&      core   = cores[next_thread];
+        core.arrivals.push(arrival, handle);
+        ++core.population.arriving;
+        ++population.arriving;
+        next_thread = (next_thread + 1) % threads_count();
+        return handle;
+    }
+
+    // Puts `handle` on the core `thread_idx`, which preempts it after `slice` ticks unless its CPU burst ends earlier
+    void run(const std::size_t thread_idx, const ProcessHandle handle, const std::size_t slice = UNLIMITED_SLICE)
+    {
+        assert(slice > 0 && "a process must be given at least one tick");
+        auto& core      = cores[thread_idx];
+        core.running    = handle;
+        core.slice_left = slice;
+        record_transition(thread_idx, TraceEvent::Dispatch, handle);
+    }
+
+    // Takes the running process off the core `thread_idx` and puts it back into its ready queue
+    void preempt(const std::size_t thread_idx)
+    {
+        auto& core = cores[thread_idx];
+        assert(core.running && "only a running process can be preempted");
+        record_transition(thread_idx, TraceEvent::Preempt, *core.running);
+
+        // NOTE: requeued the same way as after a completed burst, the rest of the current one is still ahead
+        dispatch_process_by_first_event(thread_idx, *core.running, timer + 1);
+        core.running = std::nullopt;
+    }
+
+    // Ticks the current CPU burst of the process running on the core `thread_idx` still has to run for
+    [[nodiscard]] auto remaining_burst(const std::size_t thread_idx) const -> std::size_t
+    {
+        const auto& core = cores[thread_idx];
+        assert(core.running && "core must be running a process");
+        return arena.remainings[*core.running];
+    }
+
+    [[nodiscard]] auto process(const ProcessHandle handle) const -> const Os::Process& { return arena[handle]; }
+
+    // Position of the current event of `handle` inside the event pool
+    [[nodiscard]] auto current_event(const ProcessHandle handle) const -> Os::EventPool::Index
+    {
+        return process(handle).events.offset + arena.cursors[handle];
+    }
+
+    [[nodiscard]] auto has_events(const ProcessHandle handle) const -> bool
+    {
+        return arena.cursors[handle] < process(handle).events.length;
+    }
+
+    // Ticks the IO event of a waiting process still has to run for, counting the current one.
+    // NOTE: waiting processes keep the full duration of their IO event, only its completion tick is tracked
+    [[nodiscard]] auto remaining_io_duration(const IoQueue::Entry& entry) const -> std::size_t
+    {
+        assert(entry.completion >= timer && "io completion must not be in the past");
+        return entry.completion - timer + 1;
     }
 
     [[nodiscard]] auto average_waiting_time() const -> std::size_t
     {
         if (finished.empty()) { return 0; }
 
-        std::size_t total_waiting_time = 0;
-        for (const auto& process : finished) {
-            if (!process->start_time.has_value()) { continue; }
-            total_waiting_time += process->start_time.value() - process->arrival;
-        }
-
-        return total_waiting_time / finished.size();
+        return waiting_times.total() / finished.size();
     }
 
     [[nodiscard]] auto average_turnaround_time() const -> std::size_t
     {
         if (finished.empty()) { return 0; }
 
-        std::size_t total_turnaround_time = 0;
-        for (const auto& process : finished) {
-            if (!process->finish_time.has_value()) { continue; }
-            total_turnaround_time += process->finish_time.value() - process->arrival;
-        }
-
-        return total_turnaround_time / finished.size();
+        return turnaround_times.total() / finished.size();
     }
 
     [[nodiscard]] auto average_cpu_usage() const -> double
     {
         double total_usage = 0;
-        for (std::size_t thread_idx = 0; thread_idx < threads_count; ++thread_idx) {
-            total_usage += cpu_usage[thread_idx];
-        }
+        for (const auto& core : cores) { total_usage += core.cpu_usage; }
 
-        return total_usage / static_cast<double>(threads_count);
+        return total_usage / static_cast<double>(threads_count());
     }
 
   private:
-    void sidetrack_processes(const std::size_t thread_idx)
+    // Runs `fn(thread_idx)` for every core, concurrently when stepping on more than one host thread
+    void for_each_core(const auto& fn)
     {
-        auto& procs = processes[thread_idx];
-        for (auto it = procs.begin(); it != procs.end();) {
-            auto process = *it;
-            if (process->arrival != timer) {
-                ++it;
-                continue;
+        if (workers && threads_count() > 1) {
+            workers->parallel_for(threads_count(), fn);
+        } else {
+            for (std::size_t thread_idx = 0; thread_idx < threads_count(); ++thread_idx) { fn(thread_idx); }
+        }
+    }
+
+    // NOTE: only touches the queues of `thread_idx` and the processes queued on it, see `set_host_threads`.
+    // With a global run queue the processes becoming ready are only staged, see `publish_readied`.
+    void advance_core(const std::size_t thread_idx)
+    {
+        update_waiting_list(thread_idx);
+        update_running(thread_idx);
+    }
+
+    void schedule_core(const std::size_t thread_idx)
+    {
+        auto& core  = cores[thread_idx];
+        auto& ready = ready_queue(thread_idx);
+
+        schedule_policy(*this, thread_idx);
+        if (!core.running && !ready.empty()) { run(thread_idx, ready.pop()); }
+
+        if (core.running && !arena.first_run_times[*core.running].has_value()) {
+            arena.first_run_times[*core.running] = timer;
+        }
+
+        if (core.running && has_events(*core.running)) {
+            core.cpu_usage = event_pool.resource_usage(current_event(*core.running));
+        }
+
+        count_population(core);
+    }
+
+    void end_tick()
+    {
+        // NOTE: merged in core order so that `finished` and the trace do not depend on how the cores were stepped
+        for (auto& core : cores) {
+            for (const auto handle : core.finished) { record_finished(handle); }
+            core.finished.clear();
+
+            if (trace) { trace->append(core.traced); }
+            core.traced.clear();
+        }
+
+        population = total_population();
+
+        if (complete()) {
+            for (auto& idle_core : cores) { idle_core.cpu_usage = 0.0F; }
+        }
+
+        throughput = timer != 0 ? static_cast<double>(finished.size()) / static_cast<double>(timer) : 0.0;
+        previous_finished_count = finished.size();
+
+        ++timer;
+    }
+
+    void order_ready_queues()
+    {
+        const auto key_of = [this](const ProcessHandle handle) { return ready_key(handle); };
+        for (auto& core : cores) { core.ready.rebuild(schedule_policy.ready_order(), priority_levels, key_of); }
+        shared_ready.rebuild(schedule_policy.ready_order(), priority_levels, key_of);
+    }
+
+    [[nodiscard]] auto uses_priority_levels() const -> bool
+    {
+        return schedule_policy.ready_order() == ReadyOrder::Levels;
+    }
+
+    [[nodiscard]] auto uses_virtual_runtime() const -> bool
+    {
+        return schedule_policy.ready_order() == ReadyOrder::VirtualRuntime;
+    }
+
+    // Virtual runtime `scheduled` accrues by running for `ticks` ticks
+    [[nodiscard]] auto virtual_runtime(const ProcessHandle scheduled, const std::size_t ticks) const -> std::size_t
+    {
+        return ticks * (VIRTUAL_TICK / process(scheduled).weight);
+    }
+
+    // The priority level or the virtual runtime of a ready process, or else the length of the CPU burst it is ready for
+    [[nodiscard]] auto ready_key(const ProcessHandle handle) const -> std::size_t
+    {
+        if (uses_priority_levels()) { return priority_level(handle); }
+        if (uses_virtual_runtime()) { return arena.vruntimes[handle]; }
+
+        return arena.remainings[handle];
+    }
+
+    [[nodiscard]] auto priority_boost_due() const -> bool
+    {
+        return uses_priority_levels() && priority_boost_period != 0 && timer != 0
+               && timer % priority_boost_period == 0;
+    }
+
+    [[nodiscard]] static auto idle(const Core& core) -> bool { return !core.running && core.ready.empty(); }
+
+    [[nodiscard]] auto busiest_core() const -> std::size_t
+    {
+        const auto by_ready = [](const Core& core) { return core.ready.size(); };
+        const auto busiest  = std::ranges::max_element(cores, {}, by_ready);
+        return static_cast<std::size_t>(std::ranges::distance(cores.begin(), busiest));
+    }
+
+    [[nodiscard]] auto steal_due() const -> bool
+    {
+        if (steal_threshold == 0 || global_run_queue() || !std::ranges::any_of(cores, idle)) { return false; }
+
+        return cores[busiest_core()].ready.size() >= steal_threshold;
+    }
+
+    // NOTE: serial and in core order, every idle core taking a single process from the tail of the busiest queue,
+    // like the thieves of a work-stealing deque while its owner keeps popping from the head
+    void balance_load()
+    {
+        for (std::size_t thief = 0; thief < threads_count(); ++thief) {
+            if (!idle(cores[thief])) { continue; }
+
+            const auto victim = busiest_core();
+            if (cores[victim].ready.size() < steal_threshold) { return; }
+
+            const auto handle = cores[victim].ready.steal();
+            if (uses_virtual_runtime()) {
+                // NOTE: keeps the lead the process had on the queue it leaves
+                auto&      stolen = arena.vruntimes[handle];
+                const auto lead   = stolen - std::min(stolen, cores[victim].min_vruntime);
+                stolen            = cores[thief].min_vruntime + lead;
             }
 
-            if (!ensure_pid_is_unique(thread_idx, process->pid)) {
+            make_ready(thief, handle);
+            ++cores[thief].steals;
+            ++migrations;
+        }
+    }
+
+    // NOTE: O(n) in the processes of the simulation, but only once every `priority_boost_period` ticks
+    void boost_priorities()
+    {
+        std::ranges::fill(arena.priorities, 0);
+        order_ready_queues();
+    }
+
+    static void count_population(Core& core) { core.population = counted_population(core); }
+
+    [[nodiscard]] static auto counted_population(const Core& core) -> Population
+    {
+        return Population {
+            .arriving = core.arrivals.size(),
+            .ready    = core.ready.size(),
+            .running  = core.running.has_value() ? 1UL : 0UL,
+            .waiting  = core.waiting.size(),
+        };
+    }
+
+    [[nodiscard]] auto total_population() const -> Population
+    {
+        auto total = Population { .ready = shared_ready.size(), .finished = finished.size() };
+        for (const auto& core : cores) { total += core.population; }
+
+        return total;
+    }
+
+    void record_finished(const ProcessHandle handle)
+    {
+        finished.push_back(handle);
+
+        const auto& finished_process = process(handle);
+        pids.erase(finished_process.pid);
+
+        if (const auto start_time = arena.start_times[handle]; start_time.has_value()) {
+            const auto waiting_time = start_time.value() - finished_process.arrival;
+            waiting_times.push(waiting_time);
+            waiting_time_histogram.push(waiting_time);
+        }
+        if (const auto finish_time = arena.finish_times[handle]; finish_time.has_value()) {
+            const auto turnaround_time = finish_time.value() - finished_process.arrival;
+            turnaround_times.push(turnaround_time);
+            turnaround_time_histogram.push(turnaround_time);
+        }
+        if (const auto first_run_time = arena.first_run_times[handle]; first_run_time.has_value()) {
+            response_time_histogram.push(first_run_time.value() - finished_process.arrival);
+        }
+    }
+
+    void skip_idle_ticks()
+    {
+        const auto ticks = idle_ticks();
+        if (ticks == 0) { return; }
+
+        for (auto& core : cores) {
+            if (!core.running) { continue; }
+
+            const auto scheduled = *core.running;
+            arena.remainings[scheduled] -= ticks;
+            if (core.slice_left != UNLIMITED_SLICE) { core.slice_left -= ticks; }
+            if (uses_virtual_runtime()) { arena.vruntimes[scheduled] += virtual_runtime(scheduled, ticks); }
+        }
+
+        timer += ticks;
+
+        // NOTE: matches the value `step()` would have computed during the last skipped tick
+        const auto last_tick    = timer - 1;
+        throughput              = last_tick != 0 ? static_cast<double>(finished.size()) / static_cast<double>(last_tick)
+                                                 : 0.0;
+        previous_finished_count = finished.size();
+    }
+
+    void sidetrack_processes(const std::size_t thread_idx)
+    {
+        for (const auto handle : cores[thread_idx].arrivals.take(timer)) {
+            const auto& arrived = process(handle);
+            if (pids.contains(arrived.pid)) {
                 std::println(
-                  stderr, "[ERROR] process {} with pid {} is already in use, skipping...", process->name, process->pid
+                  stderr, "[ERROR] process {} with pid {} is already in use, skipping...", arrived.name, arrived.pid
                 );
                 continue;
             }
 
-            if (process->events.empty()) {
+            if (!has_events(handle)) {
                 std::println(
                   stderr,
                   "[ERROR] process {} with pid {} should at least have one event, skipping...",
-                  process->name,
-                  process->pid
+                  arrived.name,
+                  arrived.pid
                 );
                 continue;
             }
 
-            dispatch_process_by_first_event(thread_idx, process);
-            it = procs.erase(it);
+            (void)pids.insert(arrived.pid);
+            record_transition(thread_idx, TraceEvent::Arrive, handle);
+
+            // NOTE: the waiting list of this core has not been updated yet, so an IO event starts right away
+            dispatch_process_by_first_event(thread_idx, handle, timer);
+        }
+    }
+
+    // NOTE: a branch on `trace` when not tracing, so that the transitions cost nothing otherwise
+    void record_transition(const std::size_t thread_idx, const TraceEvent event, const ProcessHandle handle)
+    {
+        if (!trace) { return; }
+
+        assert(thread_idx < TRACE_MAX_CORES && "too many cores to be traced");
+        cores[thread_idx].traced.push_back(TraceRecord {
+          .tick    = timer,
+          .pid     = process(handle).pid,
+          .process = handle,
+          .core    = static_cast<std::uint16_t>(thread_idx),
+          .event   = event,
+        });
+    }
+
+    void make_ready(const std::size_t thread_idx, const ProcessHandle handle)
+    {
+        if (uses_virtual_runtime()) {
+            auto& readied = arena.vruntimes[handle];
+            readied       = std::max(readied, min_vruntime(thread_idx));
         }
+
+        ready_queue(thread_idx).push(handle, ready_key(handle));
+    }
+
+    // Moves the processes staged by the core `thread_idx` into the global run queue
+    void publish_readied(const std::size_t thread_idx)
+    {
+        auto& core = cores[thread_idx];
+        for (const auto handle : core.readied) { make_ready(thread_idx, handle); }
+        core.readied.clear();
+    }
+
+    // NOTE: in core order, so that the global run queue does not depend on how the cores were stepped
+    void publish_readied()
+    {
+        for (std::size_t thread_idx = 0; thread_idx < threads_count(); ++thread_idx) { publish_readied(thread_idx); }
     }
 
-    void dispatch_process_by_first_event(const std::size_t thread_idx, ProcessPtr& process)
+    // `io_start` is the first tick during which an IO event, if that is what the process is on, makes progress
+    void dispatch_process_by_first_event(
+      const std::size_t   thread_idx,
+      const ProcessHandle handle,
+      const std::size_t   io_start
+    )
     {
 
         static_assert(
           std::to_underlying(Os::EventKind::Count) == 2,
           "Exhaustive handling of all variants for enum EventKind is required."
         );
-        assert(!process->events.empty() && "process queue must not be empty");
-        const auto first_event = process->events.front();
+        assert(has_events(handle) && "process queue must not be empty");
+        const auto first_event = event_pool.event(current_event(handle));
         switch (first_event.kind) {
             case Os::EventKind::Cpu: {
-                process->start_time = !process->start_time.has_value() ? std::optional { timer } : std::nullopt;
-                ready[thread_idx].push_back(process);
+                // NOTE: only the first time, a preempted process going back to its ready queue keeps its start time
+                if (!arena.start_times[handle].has_value()) { arena.start_times[handle] = timer; }
+                if (global_run_queue()) {
+                    cores[thread_idx].readied.push_back(handle);
+                } else {
+                    make_ready(thread_idx, handle);
+                }
                 break;
             }
             case Os::EventKind::Io: {
-                waiting[thread_idx].push_back(process);
+                assert(first_event.duration > 0);
+                cores[thread_idx].waiting.push(io_start + first_event.duration - 1, handle);
+                record_transition(thread_idx, TraceEvent::IoStart, handle);
                 break;
             }
             default: {
@@ -278,117 +1047,192 @@ struct [[nodiscard]] Scheduler final
         }
     }
 
-    void update_waiting_list(const std::size_t thread_idx)
+    // Moves `handle` on to its next event, which it then has the whole duration of left
+    void next_event(const ProcessHandle handle)
     {
-        auto&                   waits = waiting[thread_idx];
-        std::vector<ProcessPtr> to_dispatch;
-
-        for (auto it = waits.begin(); it != waits.end();) {
-            auto& process = *it;
-            assert(!process->events.empty() && "event queue must not be empty");
-
-            auto& current_event = process->events.front();
-            assert(current_event.kind == Os::EventKind::Io && "process in waits queue must be on an IO event");
-            assert(current_event.duration > 0);
-            --current_event.duration;
-
-            if (current_event.duration == 0) {
-                process->events.pop_front();
-                if (!process->events.empty()) {
-                    to_dispatch.push_back(process);
-                } else {
-                    process->finish_time = !process->finish_time.has_value() ? std::optional { timer } : std::nullopt;
-                    finished.push_back(process);
-                }
+        ++arena.cursors[handle];
+        if (has_events(handle)) { arena.remainings[handle] = event_pool.duration(current_event(handle)); }
+    }
 
-                it = waits.erase(it);
+    void update_waiting_list(const std::size_t thread_idx)
+    {
+        auto& waits = cores[thread_idx].waiting;
+
+        while (waits.due(timer)) {
+            const auto handle = waits.pop();
+            assert(has_events(handle) && "event queue must not be empty");
+            assert(
+              event_pool.kind(current_event(handle)) == Os::EventKind::Io
+              && "process in waits queue must be on an IO event"
+            );
+
+            record_transition(thread_idx, TraceEvent::IoEnd, handle);
+            next_event(handle);
+            if (has_events(handle)) {
+                dispatch_process_by_first_event(thread_idx, handle, timer + 1);
             } else {
-                ++it;
+                auto& finish_time = arena.finish_times[handle];
+                finish_time       = !finish_time.has_value() ? std::optional { timer } : std::nullopt;
+                cores[thread_idx].finished.push_back(handle);
+                record_transition(thread_idx, TraceEvent::Finish, handle);
             }
         }
-
-        for (auto& process : to_dispatch) { dispatch_process_by_first_event(thread_idx, process); }
     }
 
     void update_running(const std::size_t thread_idx)
     {
-        if (!running[thread_idx]) { return; }
+        auto& core = cores[thread_idx];
+        if (!core.running) { return; }
 
-        auto& process = running[thread_idx];
-        assert(!process->events.empty() && "event queue must not be empty");
+        const auto handle = *core.running;
+        assert(has_events(handle) && "event queue must not be empty");
+        assert(
+          event_pool.kind(current_event(handle)) == Os::EventKind::Cpu && "process running must be on an CPU event"
+        );
 
-        auto& current_event = process->events.front();
-        assert(current_event.kind == Os::EventKind::Cpu && "process running must be on an CPU event");
-        assert(current_event.duration > 0);
-        --current_event.duration;
+        auto& remaining = arena.remainings[handle];
+        assert(remaining > 0 && core.slice_left > 0);
+        --remaining;
+        if (core.slice_left != UNLIMITED_SLICE) { --core.slice_left; }
+        if (uses_virtual_runtime()) { arena.vruntimes[handle] += virtual_runtime(handle, 1); }
 
-        if (current_event.duration == 0) {
-            process->events.pop_front();
-            if (!process->events.empty()) {
-                dispatch_process_by_first_event(thread_idx, process);
+        if (remaining == 0) {
+            next_event(handle);
+            if (has_events(handle)) {
+                dispatch_process_by_first_event(thread_idx, handle, timer + 1);
             } else {
-                finished.push_back(process);
+                core.finished.push_back(handle);
+                record_transition(thread_idx, TraceEvent::Finish, handle);
             }
 
-            running[thread_idx] = nullptr;
+            core.running = std::nullopt;
+        } else if (core.slice_left == 0) {
+            if (uses_priority_levels()) {
+                auto& priority = arena.priorities[handle];
+                priority       = std::min(priority + 1, priority_levels - 1);
+            }
+            preempt(thread_idx);
         }
     }
+};
 
-    [[nodiscard]] auto ensure_pid_is_unique(const std::size_t thread_idx, const std::size_t pid) const -> bool
+struct [[nodiscard]] FirstComeFirstServedPolicy final
+{
+    [[nodiscard]] constexpr static auto ready_order() -> ReadyOrder { return ReadyOrder::Fifo; }
+
+    template<typename Simulation>
+    void operator()(Simulation& sim, const std::size_t thread_idx) const
     {
-        const auto comparator = [&](const auto& elem) { return elem->pid == pid; };
-        return (!running[thread_idx] || running[thread_idx]->pid != pid)
-               && std::ranges::find_if(ready[thread_idx], comparator) == ready[thread_idx].end()
-               && std::ranges::find_if(waiting[thread_idx], comparator) == waiting[thread_idx].end();
+        auto& ready = sim.ready_queue(thread_idx);
+        if (sim.cores[thread_idx].running || ready.empty()) { return; }
+
+        sim.run(thread_idx, ready.pop());
     }
 };
 
-struct [[nodiscard]] FirstComeFirstServedPolicy final
+// NOTE: preempts through the time slice of the core, the events of the process are left untouched
+struct [[nodiscard]] RoundRobinPolicy final
+{
+    [[nodiscard]] constexpr static auto ready_order() -> ReadyOrder { return ReadyOrder::Fifo; }
+
+    template<typename Simulation>
+    void operator()(Simulation& sim, const std::size_t thread_idx) const
+    {
+        auto& ready = sim.ready_queue(thread_idx);
+        if (sim.cores[thread_idx].running || ready.empty()) { return; }
+
+        const auto handle = ready.pop();
+
+        assert(sim.has_events(handle) && "process queue must not be empty");
+        assert(
+          sim.event_pool.kind(sim.current_event(handle)) == Os::EventKind::Cpu
+          && "event of process in ready must be cpu"
+        );
+
+        sim.run(thread_idx, handle, sim.quantum);
+    }
+};
+
+// NOTE: the ready queues are heaps keyed on the length of the CPU burst each process is ready for
+struct [[nodiscard]] ShortestJobFirstPolicy final
+{
+    [[nodiscard]] constexpr static auto ready_order() -> ReadyOrder { return ReadyOrder::SmallestKey; }
+
+    template<typename Simulation>
+    void operator()(Simulation& sim, const std::size_t thread_idx) const
+    {
+        auto& ready = sim.ready_queue(thread_idx);
+        if (sim.cores[thread_idx].running || ready.empty()) { return; }
+
+        sim.run(thread_idx, ready.pop());
+    }
+};
+
+// Multi Level Feedback Queue: runs the first process of the highest non-empty priority level for the quantum
+// of that level, preempting a running process of a lower level.
+// NOTE: the ready queues keep one FIFO per level, picking from them is O(1) whatever the number of levels
+struct [[nodiscard]] MultiLevelFeedbackQueuePolicy final
 {
-    void operator()(Scheduler& sim) const
+    [[nodiscard]] constexpr static auto ready_order() -> ReadyOrder { return ReadyOrder::Levels; }
+
+    template<typename Simulation>
+    void operator()(Simulation& sim, const std::size_t thread_idx) const
     {
-        for (std::size_t thread_idx = 0; thread_idx < sim.threads_count; ++thread_idx) {
-            auto& ready = sim.ready[thread_idx];
-            if (ready.empty()) { return; }
+        const auto& core  = sim.cores[thread_idx];
+        auto&       ready = sim.ready_queue(thread_idx);
+        if (ready.empty()) { return; }
 
-            const auto process = ready.front();
-            ready.pop_front();
-            sim.running[thread_idx] = process;
+        if (core.running) {
+            if (ready.front().key >= sim.priority_level(*core.running)) { return; }
+            sim.preempt(thread_idx);
         }
+
+        const auto handle = ready.pop();
+        sim.run(thread_idx, handle, sim.level_quantum(sim.priority_level(handle)));
     }
 };
 
-struct [[nodiscard]] RoundRobinPolicy final
+// Preemptive Shortest Job First: a process which becomes ready with a burst shorter than what is left of the
+// running one takes its core.
+// NOTE: a preempted process is keyed on what is left of its burst
+struct [[nodiscard]] ShortestRemainingTimeFirstPolicy final
 {
-    void operator()(Scheduler& sim) const
-    {
-        for (std::size_t thread_idx = 0; thread_idx < sim.threads_count; ++thread_idx) {
-            auto& ready = sim.ready[thread_idx];
-
-            if (ready.empty()) { return; }
-
-            const auto process = ready.front();
-            ready.pop_front();
-            sim.running[thread_idx] = process;
-
-            auto& events = process->events;
-            assert(!events.empty() && "process queue must not be empty");
-            auto& next_event = events.front();
-            assert(next_event.kind == Os::EventKind::Cpu && "event of process in ready must be cpu");
-
-            if (next_event.duration > quantum) {
-                next_event.duration -= quantum;
-                const auto new_event = Os::Event {
-                    .kind           = Os::EventKind::Cpu,
-                    .duration       = quantum,
-                    .resource_usage = next_event.resource_usage,
-                };
-                events.push_front(new_event);
-            }
+    [[nodiscard]] constexpr static auto ready_order() -> ReadyOrder { return ReadyOrder::SmallestKey; }
+
+    template<typename Simulation>
+    void operator()(Simulation& sim, const std::size_t thread_idx) const
+    {
+        const auto& core  = sim.cores[thread_idx];
+        auto&       ready = sim.ready_queue(thread_idx);
+        if (ready.empty()) { return; }
+
+        if (core.running) {
+            if (ready.front().key >= sim.remaining_burst(thread_idx)) { return; }
+            sim.preempt(thread_idx);
         }
+
+        sim.run(thread_idx, ready.pop());
     }
+};
+
+// Completely Fair Scheduler: runs the process with the least virtual runtime for a quantum, the virtual runtime of a
+// process growing with the ticks it runs for divided by its weight, so that heavier processes get more of the core.
+// NOTE: the ready queues are heaps keyed on virtual runtime, inserting is O(log n) and the next pick sits at the root
+struct [[nodiscard]] CompletelyFairPolicy final
+{
+    [[nodiscard]] constexpr static auto ready_order() -> ReadyOrder { return ReadyOrder::VirtualRuntime; }
+
+    template<typename Simulation>
+    void operator()(Simulation& sim, const std::size_t thread_idx) const
+    {
+        auto& ready = sim.ready_queue(thread_idx);
+        if (sim.cores[thread_idx].running || ready.empty()) { return; }
 
-    std::size_t quantum = 5;
+        const auto handle       = ready.pop();
+        auto&      min_vruntime = sim.min_vruntime(thread_idx);
+        min_vruntime            = std::max(min_vruntime, sim.arena.vruntimes[handle]);
+        sim.run(thread_idx, handle, sim.quantum);
+    }
 };
 
 [[nodiscard]] constexpr static auto try_policy_from_str(const std::string_view str) -> std::optional<SchedulePolicy>
@@ -400,6 +1244,15 @@ struct [[nodiscard]] RoundRobinPolicy final
         { "FirstInFirstOut", SchedulePolicy::FirstComeFirstServed },
         { "RR", SchedulePolicy::RoundRobin },
         { "RoundRobin", SchedulePolicy::RoundRobin },
+        { "SJF", SchedulePolicy::ShortestJobFirst },
+        { "ShortestJobFirst", SchedulePolicy::ShortestJobFirst },
+        { "SRTF", SchedulePolicy::ShortestRemainingTimeFirst },
+        { "ShortestRemainingTimeFirst", SchedulePolicy::ShortestRemainingTimeFirst },
+        { "MLFQ", SchedulePolicy::MultiLevelFeedbackQueue },
+        { "MultiLevelFeedbackQueue", SchedulePolicy::MultiLevelFeedbackQueue },
+        { "CFS", SchedulePolicy::CompletelyFair },
+        { "CompletelyFair", SchedulePolicy::CompletelyFair },
+        { "CompletelyFairScheduler", SchedulePolicy::CompletelyFair },
     };
 
     if (!map.contains(str)) {
@@ -410,10 +1263,26 @@ struct [[nodiscard]] RoundRobinPolicy final
     return std::make_optional(map.at(str));
 }
 
+[[nodiscard]] constexpr static auto try_run_queue_mode_from_str(const std::string_view str)
+  -> std::optional<RunQueueMode>
+{
+    static const std::unordered_map<std::string_view, RunQueueMode> map = {
+        { "PerCore", RunQueueMode::PerCore },
+        { "Global", RunQueueMode::Global },
+    };
+
+    if (!map.contains(str)) {
+        std::println("[ERROR] (scheduler) failed to deduce run queue mode from: {}", str);
+        return std::nullopt;
+    }
+
+    return std::make_optional(map.at(str));
+}
+
 [[nodiscard]] constexpr static auto policy_name_from_kind(SchedulePolicy policy) -> std::string
 {
     static_assert(
-      std::to_underlying(SchedulePolicy::Count) == 2,
+      std::to_underlying(SchedulePolicy::Count) == 6,
       "Exhaustive handling for all enum variants for SchedulePolicy is required"
     );
 
@@ -424,17 +1293,28 @@ struct [[nodiscard]] RoundRobinPolicy final
         case SchedulePolicy::RoundRobin: {
             return "Round Robin";
         }
+        case SchedulePolicy::ShortestJobFirst: {
+            return "Shortest Job First";
+        }
+        case SchedulePolicy::ShortestRemainingTimeFirst: {
+            return "Shortest Remaining Time First";
+        }
+        case SchedulePolicy::MultiLevelFeedbackQueue: {
+            return "Multi Level Feedback Queue";
+        }
+        case SchedulePolicy::CompletelyFair: {
+            return "Completely Fair";
+        }
         default: {
             assert(false && "unreachable");
         }
     }
 }
 
-template<typename... PolicyArgs>
-[[nodiscard]] constexpr static auto named_scheduler_from_policy(SchedulePolicy policy, PolicyArgs&&... args) -> NamedSchedulePolicy
+[[nodiscard]] constexpr static auto named_scheduler_from_policy(SchedulePolicy policy) -> NamedSchedulePolicy
 {
     static_assert(
-      std::to_underlying(SchedulePolicy::Count) == 2,
+      std::to_underlying(SchedulePolicy::Count) == 6,
       "Exhaustive handling for all enum variants for SchedulePolicy is required"
     );
 
@@ -444,7 +1324,19 @@ template<typename... PolicyArgs>
             return NamedSchedulePolicy(name, policy, FirstComeFirstServedPolicy {});
         }
         case SchedulePolicy::RoundRobin: {
-            return NamedSchedulePolicy(name, policy, RoundRobinPolicy { std::forward<PolicyArgs>(args)... });
+            return NamedSchedulePolicy(name, policy, RoundRobinPolicy {});
+        }
+        case SchedulePolicy::ShortestJobFirst: {
+            return NamedSchedulePolicy(name, policy, ShortestJobFirstPolicy {});
+        }
+        case SchedulePolicy::ShortestRemainingTimeFirst: {
+            return NamedSchedulePolicy(name, policy, ShortestRemainingTimeFirstPolicy {});
+        }
+        case SchedulePolicy::MultiLevelFeedbackQueue: {
+            return NamedSchedulePolicy(name, policy, MultiLevelFeedbackQueuePolicy {});
+        }
+        case SchedulePolicy::CompletelyFair: {
+            return NamedSchedulePolicy(name, policy, CompletelyFairPolicy {});
         }
         default: {
             assert(false && "unreachable");
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Scheduler.hpp"
+
+namespace Simulations
+{
+
+// Binary snapshots of the whole state of a simulation at any tick, to resume it or fork it from there.
+//
+// Layout, in native byte order:
+//   header  the 8 bytes `SIMOSNAP`, u32 `SNAPSHOT_VERSION`, u8 sizeof(std::size_t), u8 1 if little endian
+//   policy  u8 `SchedulePolicy`, only for the simulations whose policy can be switched at runtime
+//   state   the fields visited by `BasicScheduler::serialize`, followed by the extra fields of `save_snapshot`
+// where every field is written as:
+//   - a type with a `serialize` member: the fields it visits, in order
+//   - std::optional: u8 1 followed by the value, or u8 0
+//   - a container or a string: u64 size followed by the elements, in a single block when trivially copyable and
+//     not checked one by one
+//   - any other trivially copyable value: its object representation
+// NOTE: the object representations tie a snapshot to the build which wrote it, which the header only partly checks.
+// The values of a bool or of an enum with a `Count` enumerator are checked when read back, and the state as a whole
+// with `BasicScheduler::consistent`, so that a corrupted snapshot is rejected instead of loaded
+constexpr std::string_view SNAPSHOT_MAGIC   = "SIMOSNAP";
+constexpr std::uint32_t    SNAPSHOT_VERSION = 4;
+
+namespace Detail
+{
+
+template<typename T>
+constexpr bool is_optional = false;
+
+template<typename T>
+constexpr bool is_optional<std::optional<T>> = true;
+
+template<typename T>
+constexpr bool is_pair = false;
+
+template<typename First, typename Second>
+constexpr bool is_pair<std::pair<First, Second>> = true;
+
+template<typename T>
+concept Map = requires {
+    typename T::key_type;
+    typename T::mapped_type;
+};
+
+template<typename T>
+concept CountedEnum = std::is_enum_v<T> && requires { T::Count; };
+
+// NOTE: the types whose object representations are not all values, which are read back one by one to be checked
+template<typename T>
+constexpr bool is_checked = std::same_as<T, bool> || CountedEnum<T> || is_optional<T>;
+
+template<typename T>
+concept TriviallyCopyableBlock = std::ranges::contiguous_range<T>
+                                 && std::is_trivially_copyable_v<std::ranges::range_value_t<T>>
+                                 && !is_checked<std::ranges::range_value_t<T>>;
+
+} // namespace Detail
+
+// Appends the fields it is called with to `bytes`, see the layout above
+struct [[nodiscard]] SnapshotWriter final
+{
+    std::vector<std::byte>& bytes;
+
+    template<typename... Fields>
+    void operator()(const Fields&... fields)
+    {
+        (write(fields), ...);
+    }
+
+  private:
+    void append(const void* data, const std::size_t size)
+    {
+        const auto* first = static_cast<const std::byte*>(data);
+        bytes.insert(bytes.end(), first, first + size);
+    }
+
+    template<typename T>
+    void write(const T& value)
+    {
+        if constexpr (requires { value.serialize(*this); }) {
+            value.serialize(*this);
+        } else if constexpr (Detail::is_optional<T>) {
+            write(static_cast<std::uint8_t>(value.has_value()));
+            if (value.has_value()) { write(*value); }
+        } else if constexpr (Detail::is_pair<T>) {
+            write(value.first);
+            write(value.second);
+        } else if constexpr (std::same_as<T, bool>) {
+            write(static_cast<std::uint8_t>(value));
+        } else if constexpr (std::is_trivially_copyable_v<T>) {
+            append(&value, sizeof(T));
+        } else if constexpr (std::ranges::sized_range<T>) {
+            write(static_cast<std::uint64_t>(std::ranges::size(value)));
+            if constexpr (Detail::TriviallyCopyableBlock<T>) {
+                append(std::ranges::data(value), std::ranges::size(value) * sizeof(std::ranges::range_value_t<T>));
+            } else {
+                for (const auto& element : value) { write(element); }
+            }
+        } else {
+            static_assert(false, "type cannot be written to a snapshot");
+        }
+    }
+};
+
+// Reads the fields it is called with back from `bytes`, consuming them. Reading past the end sets `failed`
+// and leaves the following fields untouched.
+struct [[nodiscard]] SnapshotReader final
+{
+    std::span<const std::byte> bytes;
+    bool                       failed = false;
+
+    template<typename... Fields>
+    void operator()(Fields&... fields)
+    {
+        (read(fields), ...);
+    }
+
+    [[nodiscard]] auto exhausted() const -> bool { return bytes.empty(); }
+
+  private:
+    void take(void* data, const std::size_t size)
+    {
+        if (size > bytes.size()) {
+            failed = true;
+            return;
+        }
+
+        std::memcpy(data, bytes.data(), size);
+        bytes = bytes.subspan(size);
+    }
+
+    // NOTE: every element takes at least one byte, which bounds the sizes a corrupted snapshot can claim
+    [[nodiscard]] auto take_size() -> std::size_t
+    {
+        std::uint64_t size = 0;
+        read(size);
+        if (size > bytes.size()) {
+            failed = true;
+            return 0;
+        }
+
+        return static_cast<std::size_t>(size);
+    }
+
+    template<typename T>
+    void read(T& value)
+    {
+        if (failed) { return; }
+
+        if constexpr (requires { value.serialize(*this); }) {
+            value.serialize(*this);
+        } else if constexpr (Detail::is_optional<T>) {
+            std::uint8_t engaged = 0;
+            read(engaged);
+            if (engaged != 0) {
+                read(value.emplace());
+            } else {
+                value.reset();
+            }
+        } else if constexpr (std::same_as<T, bool>) {
+            std::uint8_t byte = 0;
+            take(&byte, sizeof(byte));
+            failed = failed || byte > 1;
+            value  = byte == 1;
+        } else if constexpr (Detail::CountedEnum<T>) {
+            auto underlying = std::to_underlying(T::Count);
+            take(&underlying, sizeof(underlying));
+            failed = failed || underlying >= std::to_underlying(T::Count);
+            value  = static_cast<T>(underlying);
+        } else if constexpr (std::is_trivially_copyable_v<T>) {
+            take(&value, sizeof(T));
+        } else if constexpr (Detail::Map<T>) {
+            const auto size = take_size();
+            value.clear();
+            for (std::size_t idx = 0; idx < size && !failed; ++idx) {
+                typename T::key_type    key {};
+                typename T::mapped_type mapped {};
+                read(key);
+                read(mapped);
+                value.emplace_hint(value.end(), std::move(key), std::move(mapped));
+            }
+        } else if constexpr (std::ranges::sized_range<T>) {
+            const auto size = take_size();
+            value.clear();
+            value.resize(size);
+            if constexpr (Detail::TriviallyCopyableBlock<T>) {
+                take(std::ranges::data(value), size * sizeof(std::ranges::range_value_t<T>));
+            } else {
+                for (auto& element : value) { read(element); }
+            }
+        } else {
+            static_assert(false, "type cannot be read from a snapshot");
+        }
+    }
+};
+
+// Overwrites `bytes` with a snapshot of `sim`, followed by `extras`. Reusing the same buffer across snapshots
+// spares its allocation, so a long run can be checkpointed every few ticks.
+template<typename Policy, typename... Extras>
+void save_snapshot(const BasicScheduler<Policy>& sim, std::vector<std::byte>& bytes, const Extras&... extras)
+{
+    bytes.clear();
+    SnapshotWriter writer { bytes };
+
+    std::array<char, SNAPSHOT_MAGIC.size()> magic {};
+    std::ranges::copy(SNAPSHOT_MAGIC, magic.begin());
+    writer(
+      magic,
+      SNAPSHOT_VERSION,
+      static_cast<std::uint8_t>(sizeof(std::size_t)),
+      static_cast<std::uint8_t>(std::endian::native == std::endian::little)
+    );
+
+    if constexpr (std::same_as<Policy, NamedSchedulePolicy>) { writer(sim.schedule_policy.kind()); }
+
+    writer(sim, extras...);
+}
+
+// Replaces the state of `sim` and `extras` with the ones in the snapshot, keeping the host threads and the trace of
+// `sim`.
+// NOTE: decoded and checked aside first, so an invalid snapshot leaves them untouched
+template<typename Policy, typename... Extras>
+[[nodiscard]] auto load_snapshot(BasicScheduler<Policy>& sim, const std::span<const std::byte> bytes, Extras&... extras)
+  -> bool
+{
+    SnapshotReader reader { .bytes = bytes };
+
+    std::array<char, SNAPSHOT_MAGIC.size()> magic         = {};
+    std::uint32_t                           version       = 0;
+    std::uint8_t                            size_width    = 0;
+    std::uint8_t                            little_endian = 0;
+    reader(magic, version, size_width, little_endian);
+
+    if (reader.failed || std::string_view { magic.data(), magic.size() } != SNAPSHOT_MAGIC) {
+        std::println(stderr, "[ERROR] (snapshot) not a snapshot of a simulation");
+        return false;
+    }
+
+    if (version != SNAPSHOT_VERSION || size_width != sizeof(std::size_t)
+        || (little_endian != 0) != (std::endian::native == std::endian::little)) {
+        std::println(stderr, "[ERROR] (snapshot) snapshot was written by an incompatible version of sim-os");
+        return false;
+    }
+
+    BasicScheduler<Policy> loaded { sim.schedule_policy };
+    if constexpr (std::same_as<Policy, NamedSchedulePolicy>) {
+        auto kind = SchedulePolicy::Count;
+        reader(kind);
+        if (reader.failed || std::to_underlying(kind) >= std::to_underlying(SchedulePolicy::Count)) {
+            std::println(stderr, "[ERROR] (snapshot) unknown schedule policy");
+            return false;
+        }
+
+        loaded.switch_schedule_policy(named_scheduler_from_policy(kind));
+    }
+
+    std::tuple<Extras...> loaded_extras;
+    reader(loaded);
+    std::apply([&](auto&... fields) { reader(fields...); }, loaded_extras);
+
+    if (reader.failed || !reader.exhausted() || !loaded.consistent()) {
+        std::println(stderr, "[ERROR] (snapshot) snapshot is truncated or corrupted");
+        return false;
+    }
+
+    loaded.workers      = std::move(sim.workers);
+    loaded.trace        = std::move(sim.trace);
+    sim                 = std::move(loaded);
+    std::tie(extras...) = std::move(loaded_extras);
+    return true;
+}
+
+// NOTE: written next to `path` and then renamed over it, so a crash while writing never leaves a torn snapshot
+[[nodiscard]] inline auto write_snapshot_file(const std::filesystem::path& path, const std::span<const std::byte> bytes)
+  -> bool
+{
+    auto partial = path;
+    partial += ".partial";
+
+    {
+        std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            std::println(stderr, "[ERROR] (snapshot) unable to write file {}", partial.string());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(partial, path, error);
+    if (error) {
+        std::println(stderr, "[ERROR] (snapshot) unable to replace file {}: {}", path.string(), error.message());
+        return false;
+    }
+
+    return true;
+}
+
+[[nodiscard]] inline auto read_snapshot_file(const std::filesystem::path& path) -> std::optional<std::vector<std::byte>>
+{
+    std::error_code error;
+    const auto      size = std::filesystem::file_size(path, error);
+    if (error) {
+        std::println(stderr, "[ERROR] (snapshot) unable to read file {}: {}", path.string(), error.message());
+        return std::nullopt;
+    }
+
+    std::vector<std::byte> bytes(size);
+    std::ifstream          file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        std::println(stderr, "[ERROR] (snapshot) unable to read file {}", path.string());
+        return std::nullopt;
+    }
+
+    return bytes;
+}
+
+} // namespace Simulations
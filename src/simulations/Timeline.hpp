@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "Scheduler.hpp"
+#include "Snapshot.hpp"
+
+namespace Simulations
+{
+
+// Keyframes of a simulation taken every `period` ticks while it is stepped, so that seeking to any tick restores
+// the last keyframe before it and steps at most `period` ticks from there, instead of replaying from tick 0.
+// NOTE: once the keyframes outgrow `memory_budget` bytes every other one is dropped and the period doubles, so
+// memory stays bounded however long the simulation runs, at the cost of longer seeks
+template<typename Policy>
+struct [[nodiscard]] Timeline final
+{
+    using Simulation = BasicScheduler<Policy>;
+
+    constexpr static std::size_t DEFAULT_PERIOD        = 100;
+    constexpr static std::size_t DEFAULT_MEMORY_BUDGET = std::size_t { 256 } << 20U;
+
+    struct [[nodiscard]] Keyframe final
+    {
+        std::size_t            tick = 0;
+        std::vector<std::byte> snapshot;
+    };
+
+    std::size_t period        = DEFAULT_PERIOD;
+    std::size_t memory_budget = DEFAULT_MEMORY_BUDGET;
+
+    // Takes a keyframe if `sim` reached a tick past the last one at which one is due, `extras` being saved with it.
+    // Meant to be called after every step.
+    void record(const Simulation& sim, const auto&... extras)
+    {
+        last = std::max(last, sim.timer);
+        if (sim.timer % period != 0 || (!keyframes.empty() && keyframes.back().tick >= sim.timer)) { return; }
+
+        push(sim, extras...);
+    }
+
+    // Forgets the keyframes from the current tick of `sim` on, which was changed in a way stepping does not
+    // reproduce (e.g. its policy was switched), and takes a keyframe of it as it is now
+    void branch(const Simulation& sim, const auto&... extras)
+    {
+        forget_after(sim.timer);
+        branches.push_back(sim.timer);
+        last = sim.timer;
+        push(sim, extras...);
+    }
+
+    // Brings `sim` and `extras` to `tick`, calling `on_step()` after every tick stepped to get there
+    [[nodiscard]] auto seek(Simulation& sim, const std::size_t tick, const auto& on_step, auto&... extras) -> bool
+    {
+        assert(!keyframes.empty() && "timeline must hold at least the keyframe of the first tick");
+
+        // NOTE: stepping on is cheaper than restoring when the keyframe would land before the current tick
+        const auto keyframe = std::prev(std::ranges::upper_bound(keyframes, tick, {}, &Keyframe::tick));
+        if (tick < sim.timer || keyframe->tick > sim.timer) {
+            if (!load_snapshot(sim, keyframe->snapshot, extras...)) { return false; }
+
+            // NOTE: stepping on from before a branch follows the simulation as it was before being changed, so the
+            // keyframes taken after it would no longer be reached by stepping
+            if (!branches.empty() && branches.back() > keyframe->tick) {
+                forget_after(keyframe->tick + 1);
+                last = keyframe->tick;
+            }
+        }
+
+        while (sim.timer < tick && !sim.complete()) {
+            sim.step();
+            std::invoke(on_step);
+            record(sim, extras...);
+        }
+
+        return true;
+    }
+
+    // Furthest tick the simulation was stepped to
+    [[nodiscard]] auto last_tick() const -> std::size_t { return last; }
+
+    // Bytes taken by the snapshots of the keyframes
+    [[nodiscard]] auto memory_usage() const -> std::size_t { return bytes; }
+
+    void clear()
+    {
+        keyframes.clear();
+        branches.clear();
+        period = DEFAULT_PERIOD;
+        bytes  = 0;
+        last   = 0;
+    }
+
+  private:
+    // NOTE: forgets the keyframes and the branches from `tick` on
+    void forget_after(const std::size_t tick)
+    {
+        std::erase_if(keyframes, [&](const Keyframe& keyframe) { return keyframe.tick >= tick; });
+        std::erase_if(branches, [&](const std::size_t branch) { return branch >= tick; });
+
+        bytes = 0;
+        for (const auto& keyframe : keyframes) { bytes += keyframe.snapshot.size(); }
+    }
+
+    void push(const Simulation& sim, const auto&... extras)
+    {
+        auto& keyframe = keyframes.emplace_back(Keyframe { .tick = sim.timer });
+        save_snapshot(sim, keyframe.snapshot, extras...);
+        keyframe.snapshot.shrink_to_fit();
+        bytes += keyframe.snapshot.size();
+
+        while (bytes > memory_budget && keyframes.size() > 1) { thin_out(); }
+    }
+
+    // NOTE: keeps the first keyframe, so that every tick can still be sought
+    void thin_out()
+    {
+        std::size_t kept = 0;
+        for (std::size_t idx = 0; idx < keyframes.size(); idx += 2) { keyframes[kept++] = std::move(keyframes[idx]); }
+        keyframes.resize(kept);
+
+        bytes = 0;
+        for (const auto& keyframe : keyframes) { bytes += keyframe.snapshot.size(); }
+        period *= 2;
+    }
+
+    std::vector<Keyframe> keyframes;
+    std::size_t           bytes = 0;
+    std::size_t           last  = 0;
+
+    // NOTE: ticks at which the simulation was branched, in increasing order
+    std::vector<std::size_t> branches;
+};
+
+} // namespace Simulations
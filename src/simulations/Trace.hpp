@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Simulations
+{
+
+// Binary trace of the state transitions of the processes of a simulation, for tools to analyse a run offline.
+//
+// Layout, in native byte order:
+//   header   the 8 bytes `SIMOTRAC`, u32 `TRACE_VERSION`, u16 sizeof(TraceRecord), u8 1 if little endian, u8 0,
+//            u64 number of records
+//   records  one `TraceRecord` of 24 bytes per transition: u64 tick, u64 pid, u32 process, u16 core,
+//            u8 `TraceEvent`, u8 0
+// `tick` is the tick during which the transition happened. The records are in tick order and, within a tick, grouped
+// by core in core order, each group in the order the transitions happened on its core. `process` is the index of the
+// process in the order it was spawned, which unlike the pid is never shared by two processes. The restarts of a traced
+// simulation show as the ticks starting over from 0. A simulation of more than `TRACE_MAX_CORES` cores cannot be
+// traced.
+// NOTE: the file grows by whole chunks while it is written and is cut down to its records once closed, so the records
+// past the count of the header, left over by a crash, are to be ignored
+constexpr std::string_view TRACE_MAGIC   = "SIMOTRAC";
+constexpr std::uint32_t    TRACE_VERSION = 1;
+
+enum class TraceEvent : std::uint8_t
+{
+    // NOTE: the process was admitted on the core, a process whose pid is in use never arrives
+    Arrive = 0,
+    Dispatch,
+    Preempt,
+    IoStart,
+    IoEnd,
+    Finish,
+    Count,
+};
+
+struct [[nodiscard]] TraceRecord final
+{
+    std::uint64_t tick     = 0;
+    std::uint64_t pid      = 0;
+    std::uint32_t process  = 0;
+    std::uint16_t core     = 0;
+    TraceEvent    event    = TraceEvent::Arrive;
+    std::uint8_t  reserved = 0;
+};
+
+static_assert(sizeof(TraceRecord) == 24 && std::is_trivially_copyable_v<TraceRecord>, "trace layout changed");
+
+// NOTE: as many as the `core` field of a record can tell apart
+constexpr std::size_t TRACE_MAX_CORES = std::size_t { std::numeric_limits<decltype(TraceRecord::core)>::max() } + 1;
+
+struct [[nodiscard]] TraceHeader final
+{
+    std::array<char, TRACE_MAGIC.size()> magic {};
+    std::uint32_t                        version       = TRACE_VERSION;
+    std::uint16_t                        record_size   = sizeof(TraceRecord);
+    std::uint8_t                         little_endian = std::endian::native == std::endian::little ? 1 : 0;
+    std::uint8_t                         reserved      = 0;
+    std::uint64_t                        records       = 0;
+};
+
+static_assert(sizeof(TraceHeader) == 24 && std::is_trivially_copyable_v<TraceHeader>, "trace layout changed");
+
+// Append-only trace file mapped into memory, so that appending records is a copy into the page cache.
+// NOTE: the record count of the header is updated after every append, a run that crashes leaves a readable trace
+struct [[nodiscard]] TraceFile final
+{
+    // NOTE: records the file grows by at least whenever it is full, so that the mapping is seldom replaced
+    constexpr static std::size_t CHUNK_RECORDS = std::size_t { 1 } << 16U;
+
+    [[nodiscard]] static auto create(const std::filesystem::path& path) -> std::unique_ptr<TraceFile>
+    {
+        const auto fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::println(stderr, "[ERROR] (trace) unable to open file {}: {}", path.string(), last_error());
+            return nullptr;
+        }
+
+        auto file = std::unique_ptr<TraceFile>(new TraceFile { fd, path });
+        if (!file->grow(CHUNK_RECORDS)) { return nullptr; }
+
+        TraceHeader header;
+        std::ranges::copy(TRACE_MAGIC, header.magic.begin());
+        std::memcpy(file->mapping, &header, sizeof(header));
+        return file;
+    }
+
+    ~TraceFile()
+    {
+        if (mapping != nullptr) { ::munmap(mapping, mapped_bytes); }
+        if (::ftruncate(fd, static_cast<off_t>(bytes_for(count))) != 0) {
+            std::println(stderr, "[ERROR] (trace) unable to truncate file {}: {}", path.string(), last_error());
+        }
+        ::close(fd);
+    }
+
+    TraceFile(const TraceFile&)            = delete;
+    TraceFile& operator=(const TraceFile&) = delete;
+    TraceFile(TraceFile&&)                 = delete;
+    TraceFile& operator=(TraceFile&&)      = delete;
+
+    // NOTE: once growing the file failed, the records are dropped and `failed()` tells so
+    void append(const std::span<const TraceRecord> records)
+    {
+        if (records.empty() || failed()) { return; }
+        if (count + records.size() > capacity && !grow(std::max(2 * capacity, count + records.size()))) { return; }
+
+        std::memcpy(mapping + bytes_for(count), records.data(), records.size_bytes());
+        count += records.size();
+
+        const std::uint64_t written = count;
+        std::memcpy(mapping + offsetof(TraceHeader, records), &written, sizeof(written));
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return count; }
+    [[nodiscard]] auto failed() const -> bool { return mapping == nullptr; }
+
+  private:
+    TraceFile(const int fd, std::filesystem::path path)
+      : fd { fd },
+        path { std::move(path) }
+    {}
+
+    [[nodiscard]] static auto bytes_for(const std::size_t records) -> std::size_t
+    {
+        return sizeof(TraceHeader) + records * sizeof(TraceRecord);
+    }
+
+    [[nodiscard]] static auto last_error() -> std::string
+    {
+        return std::error_code { errno, std::generic_category() }.message();
+    }
+
+    // NOTE: mapped again as a whole, the records already written stay in the page cache and are not copied
+    [[nodiscard]] auto grow(const std::size_t records) -> bool
+    {
+        if (mapping != nullptr) { ::munmap(mapping, mapped_bytes); }
+        mapping = nullptr;
+
+        const auto bytes = bytes_for(records);
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            std::println(stderr, "[ERROR] (trace) unable to grow file {}: {}", path.string(), last_error());
+            return false;
+        }
+
+        auto* mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            std::println(stderr, "[ERROR] (trace) unable to map file {}: {}", path.string(), last_error());
+            return false;
+        }
+
+        mapping      = static_cast<std::byte*>(mapped);
+        mapped_bytes = bytes;
+        capacity     = records;
+        return true;
+    }
+
+    int                   fd;
+    std::filesystem::path path;
+    std::byte*            mapping      = nullptr;
+    std::size_t           mapped_bytes = 0;
+    std::size_t           capacity     = 0;
+    std::size_t           count        = 0;
+};
+
+} // namespace Simulations
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <barrier>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace Simulations
+{
+
+// Persistent host threads running an indexed loop in lockstep with the calling thread.
+// Every `parallel_for` is fenced by two barriers, so the caller observes all the writes done by the job.
+struct [[nodiscard]] WorkerPool final
+{
+    using Job = std::function<void(std::size_t)>;
+
+    // NOTE: the calling thread takes part in every loop, so `host_threads` includes it
+    explicit WorkerPool(const std::size_t host_threads)
+      : start { static_cast<std::ptrdiff_t>(host_threads) },
+        done { static_cast<std::ptrdiff_t>(host_threads) }
+    {
+        assert(host_threads > 1 && "a worker pool needs at least one thread besides the caller");
+        workers.reserve(host_threads - 1);
+        for (std::size_t idx = 1; idx < host_threads; ++idx) { workers.emplace_back([this] { work(); }); }
+    }
+
+    ~WorkerPool()
+    {
+        stopping = true;
+        start.arrive_and_wait();
+        for (auto& worker : workers) { worker.join(); }
+    }
+
+    WorkerPool(const WorkerPool&)            = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&)                 = delete;
+    WorkerPool& operator=(WorkerPool&&)      = delete;
+
+    [[nodiscard]] auto host_threads() const -> std::size_t { return workers.size() + 1; }
+
+    // Runs `fn(idx)` once for every `idx` in [0, count) and returns when all of them are done
+    void parallel_for(const std::size_t count, Job fn)
+    {
+        job        = std::move(fn);
+        job_count  = count;
+        next_index = 0;
+
+        start.arrive_and_wait();
+        drain();
+        done.arrive_and_wait();
+
+        job = nullptr;
+    }
+
+  private:
+    void work()
+    {
+        while (true) {
+            start.arrive_and_wait();
+            if (stopping) { return; }
+
+            drain();
+            done.arrive_and_wait();
+        }
+    }
+
+    void drain()
+    {
+        for (auto idx = next_index.fetch_add(1, std::memory_order_relaxed); idx < job_count;
+             idx      = next_index.fetch_add(1, std::memory_order_relaxed)) {
+            job(idx);
+        }
+    }
+
+    std::barrier<>           start;
+    std::barrier<>           done;
+    std::vector<std::thread> workers;
+
+    Job                      job;
+    std::size_t              job_count  = 0;
+    std::atomic<std::size_t> next_index = 0;
+    bool                     stopping   = false;
+};
+
+} // namespace Simulations
@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <format>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "lang/Interpreter.hpp"
+#include "simulations/Report.hpp"
+#include "simulations/Scheduler.hpp"
+#include "simulations/WorkerPool.hpp"
+
+namespace
+{
+
+constexpr std::size_t DEFAULT_SEEDS = 32;
+
+// A script constant together with all the values the sweep assigns to it
+struct [[nodiscard]] Axis final
+{
+    std::string              name;
+    std::vector<std::string> values;
+};
+
+// Results of a single simulation of the sweep
+struct [[nodiscard]] Sample final
+{
+    double timer           = 0;
+    double waiting_time    = 0;
+    double turnaround_time = 0;
+    double throughput      = 0;
+    double max_waiting     = 0;
+    double max_turnaround  = 0;
+    double p99_waiting     = 0;
+    double p99_turnaround  = 0;
+    double p99_response    = 0;
+    double migrations      = 0;
+};
+
+struct [[nodiscard]] Metric final
+{
+    std::string_view name;
+    double Sample::* field;
+};
+
+constexpr auto METRICS = std::array {
+    Metric { "timer", &Sample::timer },
+    Metric { "avg_waiting_time", &Sample::waiting_time },
+    Metric { "max_waiting_time", &Sample::max_waiting },
+    Metric { "avg_turnaround_time", &Sample::turnaround_time },
+    Metric { "max_turnaround_time", &Sample::max_turnaround },
+    Metric { "p99_waiting_time", &Sample::p99_waiting },
+    Metric { "p99_turnaround_time", &Sample::p99_turnaround },
+    Metric { "p99_response_time", &Sample::p99_response },
+    Metric { "avg_throughput", &Sample::throughput },
+    Metric { "migrations", &Sample::migrations },
+};
+
+// Distribution of one metric over all the seeds of a configuration
+struct [[nodiscard]] Summary final
+{
+    double mean   = 0;
+    double stddev = 0;
+    double p50    = 0;
+    double p90    = 0;
+    double p99    = 0;
+
+    [[nodiscard]] static auto of(std::vector<double> values) -> Summary
+    {
+        assert(!values.empty() && "a configuration runs at least one seed");
+        std::ranges::sort(values);
+
+        const auto count = static_cast<double>(values.size());
+        const auto mean  = std::ranges::fold_left(values, 0.0, std::plus {}) / count;
+
+        double squares = 0;
+        for (const auto value : values) { squares += (value - mean) * (value - mean); }
+        const auto stddev = values.size() > 1 ? std::sqrt(squares / (count - 1)) : 0.0;
+
+        // NOTE: nearest-rank percentile, always one of the observed values
+        const auto percentile = [&](const double rank) {
+            const auto idx = static_cast<std::size_t>(std::ceil(rank * count));
+            return values[std::clamp(idx, 1UL, values.size()) - 1];
+        };
+
+        return Summary {
+            .mean   = mean,
+            .stddev = stddev,
+            .p50    = percentile(0.50),
+            .p90    = percentile(0.90),
+            .p99    = percentile(0.99),
+        };
+    }
+};
+
+// `from..to` like the ranges of sim-lang, otherwise a comma separated list of values
+[[nodiscard]] auto parse_values(const std::string_view text) -> std::optional<std::vector<std::string>>
+{
+    if (const auto dots = text.find(".."); dots != std::string_view::npos) {
+        const auto from = TRY(Util::parse_number(text.substr(0, dots)));
+        const auto to   = TRY(Util::parse_number(text.substr(dots + 2)));
+        if (from >= to) {
+            std::println(stderr, "[ERROR] empty range of values: {}", text);
+            return std::nullopt;
+        }
+
+        return std::views::iota(from, to)
+               | std::views::transform([](const auto value) { return std::to_string(value); })
+               | std::ranges::to<std::vector>();
+    }
+
+    auto values = text | std::views::split(',') | std::views::transform([](auto&& value) {
+                      return std::string { Util::trim(std::string_view { value }) };
+                  })
+                  | std::ranges::to<std::vector>();
+
+    if (std::ranges::any_of(values, &std::string::empty)) {
+        std::println(stderr, "[ERROR] empty value in: {}", text);
+        return std::nullopt;
+    }
+
+    return values;
+}
+
+[[nodiscard]] auto parse_axis(const std::string_view arg) -> std::optional<Axis>
+{
+    const auto equal = arg.find('=');
+    if (equal == std::string_view::npos || equal == 0) {
+        std::println(stderr, "[ERROR] expected `constant=values`, got: {}", arg);
+        return std::nullopt;
+    }
+
+    return Axis { .name = std::string { arg.substr(0, equal) }, .values = TRY(parse_values(arg.substr(equal + 1))) };
+}
+
+// Constants assigned by the `idx`-th configuration of the grid, the last axis varying fastest
+[[nodiscard]] auto configuration(const std::span<const Axis> grid, std::size_t idx) -> Interpreter::ConstantOverrides
+{
+    Interpreter::ConstantOverrides overrides;
+    for (const auto& axis : grid | std::views::reverse) {
+        overrides.emplace(axis.name, axis.values[idx % axis.values.size()]);
+        idx /= axis.values.size();
+    }
+
+    return overrides;
+}
+
+[[nodiscard]] auto describe(const Interpreter::ConstantOverrides& overrides) -> std::string
+{
+    const auto assignment = [](const auto& pair) { return std::format("{}={}", pair.first, pair.second); };
+    return overrides | std::views::transform(assignment) | std::views::join_with(' ') | std::ranges::to<std::string>();
+}
+
+// NOTE: every simulation owns its interpreter and random engine, so runs only share the script
+[[nodiscard]] auto simulate(const std::string_view script, Interpreter::ConstantOverrides overrides)
+  -> std::optional<Sample>
+{
+    using namespace Simulations;
+
+    // NOTE: the sweep already keeps every host core busy, stepping the cores of a run in parallel would only contend
+    overrides.insert_or_assign("host_threads", "1");
+
+    auto sim = std::make_shared<Scheduler>(named_scheduler_from_policy(SchedulePolicy::RoundRobin));
+    if (!Interpreter::Interpreter<Scheduler>::eval(script, sim, std::move(overrides))) { return std::nullopt; }
+
+    MetricPeaks peaks;
+    while (!sim->complete()) {
+        sim->step_to_next_event();
+        peaks.sample(*sim);
+    }
+
+    return Sample {
+        .timer           = static_cast<double>(sim->timer),
+        .waiting_time    = static_cast<double>(sim->average_waiting_time()),
+        .turnaround_time = static_cast<double>(sim->average_turnaround_time()),
+        .throughput      = sim->throughput,
+        .max_waiting     = static_cast<double>(peaks.waiting_time),
+        .max_turnaround  = static_cast<double>(peaks.turnaround_time),
+        .p99_waiting     = static_cast<double>(sim->waiting_time_histogram.percentile(0.99)),
+        .p99_turnaround  = static_cast<double>(sim->turnaround_time_histogram.percentile(0.99)),
+        .p99_response    = static_cast<double>(sim->response_time_histogram.percentile(0.99)),
+        .migrations      = static_cast<double>(sim->migrations),
+    };
+}
+
+void usage() { std::println("usage: sim-sweep <file.sl> [constant=v1,v2,...|constant=from..to]..."); }
+
+} // namespace
+
+auto main(int argc, const char** argv) -> int
+{
+    const std::span args(argv, static_cast<std::size_t>(argc));
+    if (args.size() < 2) {
+        std::println(stderr, "[ERROR] expected file path to simulation script");
+        usage();
+        return 1;
+    }
+
+    const auto* const script_path          = args[1];
+    const auto        maybe_script_content = Util::read_entire_file(script_path);
+    if (!maybe_script_content) { return 1; }
+
+    std::vector<Axis> grid;
+    for (const auto* const arg : args | std::views::drop(2)) {
+        auto axis = parse_axis(arg);
+        if (!axis) {
+            usage();
+            return 1;
+        }
+
+        if (std::ranges::contains(grid, axis->name, &Axis::name)) {
+            std::println(stderr, "[ERROR] constant `{}` is swept more than once", axis->name);
+            return 1;
+        }
+
+        grid.push_back(std::move(*axis));
+    }
+
+    // NOTE: seeds are the innermost axis, so the runs of a configuration sit next to each other
+    auto seed_axis = Axis { .name = "seed", .values = *parse_values(std::format("0..{}", DEFAULT_SEEDS)) };
+    if (const auto seeds = std::ranges::find(grid, "seed", &Axis::name); seeds != grid.end()) {
+        seed_axis = std::move(*seeds);
+        grid.erase(seeds);
+    }
+
+    const auto configurations = std::ranges::fold_left(
+      grid | std::views::transform([](const Axis& axis) { return axis.values.size(); }), 1UL, std::multiplies {}
+    );
+    const auto seeds_count = seed_axis.values.size();
+    const auto runs        = configurations * seeds_count;
+
+    const auto host_threads = std::max(1U, std::thread::hardware_concurrency());
+    std::println(
+      stderr,
+      "[INFO] {} configurations x {} seeds, {} runs on {} host threads",
+      configurations,
+      seeds_count,
+      runs,
+      host_threads
+    );
+
+    std::println(
+      "{:<48} {:<20} {:>12} {:>12} {:>12} {:>12} {:>12}",
+      "configuration",
+      "metric",
+      "mean",
+      "stddev",
+      "p50",
+      "p90",
+      "p99"
+    );
+    std::fflush(stdout);
+
+    // NOTE: every run writes its own slot, so the outcome does not depend on the order the runs complete in
+    std::vector<std::optional<Sample>> samples(runs);
+    std::atomic<bool>                  failed = false;
+
+    // NOTE: a configuration is printed as soon as all of its seeds ran and every configuration before it was printed,
+    // so the table grows in grid order while the sweep runs and what was printed survives a crash
+    std::vector<std::size_t> seeds_left(configurations, seeds_count);
+    std::size_t              next_printed = 0;
+    std::mutex               print_mutex;
+
+    const auto print_configuration = [&](const std::size_t config) {
+        const auto label          = describe(configuration(grid, config));
+        auto       runs_of_config = std::span(samples).subspan(config * seeds_count, seeds_count);
+
+        for (const auto& metric : METRICS) {
+            const auto summary = Summary::of(
+              runs_of_config | std::views::transform([&](const auto& sample) { return (*sample).*metric.field; })
+              | std::ranges::to<std::vector>()
+            );
+            std::println(
+              "{:<48} {:<20} {:>12.2f} {:>12.2f} {:>12.2f} {:>12.2f} {:>12.2f}",
+              label.empty() ? "-" : label,
+              metric.name,
+              summary.mean,
+              summary.stddev,
+              summary.p50,
+              summary.p90,
+              summary.p99
+            );
+        }
+
+        std::ranges::fill(runs_of_config, std::nullopt);
+        std::fflush(stdout);
+    };
+
+    const auto run = [&](const std::size_t idx) {
+        if (failed.load(std::memory_order_relaxed)) { return; }
+
+        auto overrides = configuration(grid, idx / seeds_count);
+        overrides.emplace(seed_axis.name, seed_axis.values[idx % seeds_count]);
+
+        samples[idx] = simulate(*maybe_script_content, std::move(overrides));
+        if (!samples[idx]) {
+            failed.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        const std::scoped_lock lock { print_mutex };
+        --seeds_left[idx / seeds_count];
+        while (next_printed < configurations && seeds_left[next_printed] == 0) {
+            print_configuration(next_printed++);
+        }
+    };
+
+    if (host_threads > 1 && runs > 1) {
+        Simulations::WorkerPool pool { std::min<std::size_t>(host_threads, runs) };
+        pool.parallel_for(runs, run);
+    } else {
+        for (std::size_t idx = 0; idx < runs; ++idx) { run(idx); }
+    }
+
+    if (failed) {
+        std::println(stderr, "[ERROR] Could not correctly evaluate script {}", script_path);
+        return 1;
+    }
+}
@@ -0,0 +1,172 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "os/Os.hpp"
+#include "simulations/Scheduler.hpp"
+#include "simulations/Snapshot.hpp"
+
+namespace
+{
+
+using Simulation    = Simulations::BasicScheduler<Simulations::FirstComeFirstServedPolicy>;
+using ProcessHandle = Simulation::ProcessHandle;
+
+constexpr std::size_t CORES     = 2;
+constexpr std::size_t PROCESSES = 8;
+constexpr std::size_t MAX_TICKS = 1'000;
+
+// NOTE: every process runs, waits and runs again, so that stepping goes through every state a process can be in
+constexpr std::array<Os::Event, 3> WORKLOAD = {
+    Os::Event { .kind = Os::EventKind::Cpu, .duration = 4, .resource_usage = 1.0F },
+    Os::Event { .kind = Os::EventKind::Io, .duration = 3, .resource_usage = 1.0F },
+    Os::Event { .kind = Os::EventKind::Cpu, .duration = 2, .resource_usage = 1.0F },
+};
+
+// Snapshot of the state a simulation is in, once stepped until `reached(sim)`, after `corrupt(sim)` changed it,
+// which has to load only when `loads` is set
+struct [[nodiscard]] Case final
+{
+    std::string_view                       name;
+    std::function<bool(const Simulation&)> reached;
+    std::function<void(Simulation&)>       corrupt;
+    bool                                   loads = false;
+};
+
+[[nodiscard]] auto first_ready(const Simulation& sim) -> ProcessHandle { return *sim.cores[0].ready.values().begin(); }
+
+[[nodiscard]] auto has_ready(const Simulation& sim) -> bool { return !sim.cores[0].ready.empty(); }
+
+// NOTE: keeps the populations counted, so only the check under test tells the snapshot apart from a valid one
+void count_ready(Simulation& sim, Simulation::Core& core)
+{
+    ++core.population.ready;
+    ++sim.population.ready;
+}
+
+const std::vector<Case> CASES = {
+    Case {
+      .name    = "valid",
+      .reached = has_ready,
+      .corrupt = [](Simulation& /* sim */) {},
+      .loads   = true,
+    },
+    Case {
+      .name    = "ready process without events left",
+      .reached = has_ready,
+      .corrupt = [](Simulation& sim) {
+          const auto handle            = first_ready(sim);
+          sim.arena.cursors[handle]    = static_cast<std::uint32_t>(WORKLOAD.size());
+          sim.arena.remainings[handle] = 0;
+      },
+    },
+    Case {
+      .name    = "ready process on an IO event",
+      .reached = has_ready,
+      .corrupt = [](Simulation& sim) {
+          const auto handle            = first_ready(sim);
+          sim.arena.cursors[handle]    = 1;
+          sim.arena.remainings[handle] = 1;
+      },
+    },
+    Case {
+      .name    = "running process on an IO event",
+      .reached = [](const Simulation& sim) { return sim.cores[0].running.has_value(); },
+      .corrupt = [](Simulation& sim) {
+          const auto handle            = *sim.cores[0].running;
+          sim.arena.cursors[handle]    = 1;
+          sim.arena.remainings[handle] = 1;
+      },
+    },
+    Case {
+      .name    = "waiting process on a CPU event",
+      .reached = [](const Simulation& sim) { return !sim.cores[0].waiting.empty(); },
+      .corrupt = [](Simulation& sim) {
+          const auto handle            = sim.cores[0].waiting.begin()->value;
+          sim.arena.cursors[handle]    = 2;
+          sim.arena.remainings[handle] = 1;
+      },
+    },
+    Case {
+      .name    = "process ready on two cores",
+      .reached = has_ready,
+      .corrupt = [](Simulation& sim) {
+          sim.cores[1].ready.push(first_ready(sim), 0);
+          count_ready(sim, sim.cores[1]);
+      },
+    },
+    Case {
+      .name    = "process ready on a core and in the shared ready queue",
+      .reached = has_ready,
+      .corrupt = [](Simulation& sim) {
+          sim.shared_ready.push(first_ready(sim), 0);
+          ++sim.population.ready;
+      },
+    },
+    Case {
+      .name    = "process ready twice on the same core",
+      .reached = has_ready,
+      .corrupt = [](Simulation& sim) {
+          sim.cores[0].ready.push(first_ready(sim), 0);
+          count_ready(sim, sim.cores[0]);
+      },
+    },
+    Case {
+      .name    = "remaining time past the duration of the current event",
+      .reached = has_ready,
+      .corrupt = [](Simulation& sim) { sim.arena.remainings[first_ready(sim)] = WORKLOAD[0].duration + 1; },
+    },
+    Case {
+      .name    = "remaining time past the duration of the last event",
+      .reached = [](const Simulation& sim) { return !sim.finished.empty(); },
+      .corrupt = [](Simulation& sim) { sim.arena.remainings[sim.finished.front()] = WORKLOAD.back().duration + 1; },
+    },
+};
+
+[[nodiscard]] auto stepped_until(const Case& test) -> Simulation
+{
+    Simulation sim { {} };
+    sim.set_threads_count(CORES);
+    for (std::size_t pid = 0; pid < PROCESSES; ++pid) { (void)sim.emplace_process("test", pid, 0, WORKLOAD); }
+
+    while (!test.reached(sim) && sim.timer < MAX_TICKS) { sim.step(); }
+    return sim;
+}
+
+[[nodiscard]] auto passes(const Case& test) -> bool
+{
+    auto sim = stepped_until(test);
+    if (!test.reached(sim)) {
+        std::println(stderr, "[ERROR] {}: the simulation never reached the state to corrupt", test.name);
+        return false;
+    }
+
+    test.corrupt(sim);
+    std::vector<std::byte> bytes;
+    Simulations::save_snapshot(sim, bytes);
+
+    Simulation loaded { {} };
+    if (Simulations::load_snapshot(loaded, bytes) != test.loads) {
+        std::println(stderr, "[ERROR] {}: snapshot was {}", test.name, test.loads ? "rejected" : "loaded");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+auto main() -> int
+{
+    std::size_t failures = 0;
+    for (const auto& test : CASES) {
+        if (!passes(test)) { ++failures; }
+    }
+
+    std::println("{} of {} snapshot cases passed", CASES.size() - failures, CASES.size());
+    return failures == 0 ? 0 : 1;
+}